@@ -33,6 +33,22 @@ GraphApp::GraphApp(QWidget* parent) : QMainWindow(parent) {
     ui.setupUi(this);
     ui.graph->getGraphManager().setAllowEditing(true);
 
+    // These walk every node index, so removed nodes are compacted away first. Qt calls
+    // the slots of a signal in connection order, so this runs before the handlers below.
+    const auto compactBeforeTriggering = [this](QAction* action) {
+        connect(action, &QAction::triggered,
+                [this]() { ui.graph->getGraphManager().compactRemovedNodes(); });
+    };
+
+    for (const auto menu : {ui.menuTraversals, ui.menuMST, ui.menuPaths, ui.menuMFAs}) {
+        std::ranges::for_each(menu->actions(), compactBeforeTriggering);
+    }
+
+    for (const auto action :
+         {ui.actionBuild_Adjacency_List, ui.actionRandom_Graph, ui.actionSave_Graph}) {
+        compactBeforeTriggering(action);
+    }
+
     connect(ui.actionBuild_Adjacency_List, &QAction::triggered, [this]() {
         auto& graphManager = ui.graph->getGraphManager();
         if (graphManager.getNodesCount() == 0) {
@@ -90,7 +106,7 @@ GraphApp::GraphApp(QWidget* parent) : QMainWindow(parent) {
         graphManager.resetAdjacencyMatrix();
         graphManager.resizeAdjacencyMatrix(graphManager.getNodesCount());
 
-        graphManager.evaluateStorageStrategy(edgeCountInt);
+        graphManager.evaluateStorageStrategy(edgeCountInt, 0, 0);
         graphManager.randomlyAddEdges(edgeCountInt);
     });
 
@@ -139,6 +155,21 @@ GraphApp::GraphApp(QWidget* parent) : QMainWindow(parent) {
         window->show();
     });
 
+    const auto reorderNodes = [this](GraphManager::NodeOrder order) {
+        auto& graphManager = ui.graph->getGraphManager();
+        graphManager.reorderNodes(order);
+        graphManager.buildEdgeCache();
+    };
+
+    connect(ui.actionHilbert_Curve_Order, &QAction::triggered,
+            [reorderNodes]() { reorderNodes(GraphManager::NodeOrder::HILBERT_CURVE); });
+
+    connect(ui.actionReverse_Cuthill_McKee_Order, &QAction::triggered,
+            [reorderNodes]() { reorderNodes(GraphManager::NodeOrder::REVERSE_CUTHILL_MCKEE); });
+
+    connect(ui.actionBreadth_First_Order, &QAction::triggered,
+            [reorderNodes]() { reorderNodes(GraphManager::NodeOrder::BREADTH_FIRST); });
+
     connect(ui.actionChange_Scene_Dimensions, &QAction::triggered, [this]() {
         SceneSizeInput dialog(ui.graph->getSceneSize(), this);
         if (dialog.exec() == QDialog::Accepted) {
@@ -561,6 +592,13 @@ GraphApp::GraphApp(QWidget* parent) : QMainWindow(parent) {
             return;
         }
 
+        if (graphManager.isNodeRemoved(nodeIndex)) {
+            QMessageBox::information(nullptr, "Center on Node",
+                                     QString("Node %1 was removed.").arg(nodeIndex),
+                                     QMessageBox::Ok);
+            return;
+        }
+
         const auto nodePos = graphManager.getNode(nodeIndex).getPosition();
         ui.graph->centerOn(nodePos);
 
@@ -641,18 +679,29 @@ void GraphApp::saveGraph() {
         return;
     }
 
-    const auto filePath =
-        QFileDialog::getSaveFileName(this, "Save Graph", "", "Graph Files (*.graph)");
+    const auto filePath = QFileDialog::getSaveFileName(
+        this, "Save Graph", "", "Graph Files (*.graph);;Binary Graph Files (*.graphbin)");
     if (filePath.isEmpty()) {
         return;
     }
 
+    if (filePath.endsWith(".graphbin", Qt::CaseInsensitive)) {
+        try {
+            graphManager.saveBinaryGraph(filePath);
+        } catch (const std::exception& ex) {
+            QMessageBox::warning(this, "Save Graph",
+                                 QString("Failed to save graph:\n%1").arg(ex.what()));
+        }
+
+        return;
+    }
+
     builder::string_builder sb;
     sb.start_object();
     {
         const auto graphSize = ui.graph->getSceneSize();
         const auto nodeCount = graphManager.getNodesCount();
-        const auto storageType = static_cast<int>(graphManager.getGraphStorage()->type());
+        const auto storageType = static_cast<int>(graphManager.getThawedGraphStorageType());
 
         sb.append_key_value<"version">(k_jsonLoadVersion);
         sb.append_comma();
@@ -680,7 +729,7 @@ void GraphApp::saveGraph() {
         sb.start_array();
         {
             for (NodeIndex_t i = 0; i < nodeCount; ++i) {
-                const auto& node = graphManager.getNode(i);
+                const auto node = graphManager.getNode(i);
                 const auto position = node.getPosition();
 
                 sb.start_object();
@@ -733,14 +782,27 @@ void GraphApp::saveGraph() {
 void GraphApp::loadGraph() {
     using namespace simdjson;
 
-    const auto filePath =
-        QFileDialog::getOpenFileName(this, "Load Graph", "", "Graph Files (*.graph)");
+    const auto filePath = QFileDialog::getOpenFileName(this, "Load Graph", "",
+                                                       "Graph Files (*.graph *.graphbin)");
     if (filePath.isEmpty()) {
         return;
     }
 
     auto& graphManager = ui.graph->getGraphManager();
 
+    if (filePath.endsWith(".graphbin", Qt::CaseInsensitive)) {
+        try {
+            ui.graph->loadBinaryGraph(filePath);
+        } catch (const std::exception& ex) {
+            QMessageBox::warning(this, "Load Graph",
+                                 QString("Failed to load graph:\n%1").arg(ex.what()));
+        }
+
+        ui.actionOriented_Graph->setChecked(graphManager.getOrientedGraph());
+        ui.actionAllow_Loops->setChecked(graphManager.getAllowLoops());
+        return;
+    }
+
     try {
         ondemand::parser parser;
         const auto json = padded_string::load(filePath.toStdWString());
@@ -782,12 +844,16 @@ void GraphApp::loadGraph() {
         graphManager.reserveNodes(nodeCount);
         graphManager.resizeAdjacencyMatrix(nodeCount);
 
+        std::vector<QPoint> positions;
+        positions.reserve(nodeCount);
+
+        std::vector<IGraphStorage::Edge_t> edges;
         for (auto node : doc["nodes"]) {
             const auto x = node["x"].get_int64().value();
             const auto y = node["y"].get_int64().value();
 
-            graphManager.addNode(QPoint(x, y));
-            const auto addedNodeIndex = static_cast<NodeIndex_t>(graphManager.getNodesCount() - 1);
+            positions.push_back(QPoint(x, y));
+            const auto addedNodeIndex = static_cast<NodeIndex_t>(positions.size() - 1);
 
             for (auto neighbour : node["edges"]) {
                 const auto neighbourIndex =
@@ -801,10 +867,14 @@ void GraphApp::loadGraph() {
                     return 0ll;
                 }();
 
-                graphManager.getGraphStorage()->addEdge(addedNodeIndex, neighbourIndex, cost);
+                edges.push_back({addedNodeIndex, neighbourIndex, static_cast<CostType_t>(cost)});
             }
         }
 
+        graphManager.addNodes(positions);
+        graphManager.addEdges(edges);
+
+        graphManager.freezeGraphStorage();
         graphManager.buildEdgeCache();
     } catch (const std::exception& ex) {
         QMessageBox::warning(this, "Load Graph",
@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * Layout of a binary graph file, native little endian:
+ * - BinaryGraphHeader_t
+ * - positions: nodeCount BinaryGraphPosition_t
+ * - offsets:   nodeCount + 1 uint64_t
+ * - targets:   edgeCount NodeIndex_t
+ * - costs:     edgeCount CostType_t
+ *
+ * The last three sections are the arrays of a CompressedSparseRow, so a loaded
+ * file is used as the frozen storage straight from the mapping. Every section
+ * starts at the header offset stored for it, aligned to BINARY_GRAPH_ALIGNMENT.
+ */
+constexpr std::array<char, 8> BINARY_GRAPH_MAGIC{'G', 'R', 'A', 'P', 'H', 'B', 'I', 'N'};
+constexpr uint32_t BINARY_GRAPH_VERSION = 1;
+constexpr uint64_t BINARY_GRAPH_ALIGNMENT = 8;
+
+struct BinaryGraphHeader_t {
+    enum Flags : uint32_t {
+        ORIENTED = 1 << 0,
+        ALLOW_LOOPS = 1 << 1,
+        DRAW_NODES = 1 << 2,
+        DRAW_EDGES = 1 << 3,
+        ALLOW_EDITING = 1 << 4,
+    };
+
+    std::array<char, 8> m_magic;
+    uint32_t m_version;
+    uint32_t m_flags;
+
+    int32_t m_sceneWidth;
+    int32_t m_sceneHeight;
+
+    // Storage the graph thaws into on the first edge edit.
+    uint32_t m_storageType;
+    uint32_t m_costWidth;
+
+    uint64_t m_nodeCount;
+    uint64_t m_edgeCount;
+
+    uint64_t m_positionsOffset;
+    uint64_t m_offsetsOffset;
+    uint64_t m_targetsOffset;
+    uint64_t m_costsOffset;
+};
+
+struct BinaryGraphPosition_t {
+    int32_t m_x;
+    int32_t m_y;
+};
+
+static_assert(sizeof(BinaryGraphHeader_t) == 80);
+static_assert(sizeof(size_t) == sizeof(uint64_t), "Offsets are mapped as size_t");
+static_assert(std::endian::native == std::endian::little);
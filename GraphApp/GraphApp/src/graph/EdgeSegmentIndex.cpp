@@ -0,0 +1,245 @@
+#include <pch.h>
+
+#include "EdgeSegmentIndex.h"
+
+#include "storage/GraphStorageVisitor.h"
+
+static int64_t floorDiv(int64_t value, int64_t divisor) {
+    return value >= 0 ? value / divisor : (value + 1) / divisor - 1;
+}
+
+// Liang-Barsky clipping, returns false when the line misses the rect.
+static bool clipLine(QLineF& line, const QRectF& rect) {
+    const std::array<std::pair<qreal, qreal>, 4> boundaries{{
+        {-line.dx(), line.x1() - rect.left()},
+        {line.dx(), rect.right() - line.x1()},
+        {-line.dy(), line.y1() - rect.top()},
+        {line.dy(), rect.bottom() - line.y1()},
+    }};
+
+    qreal enter = 0;
+    qreal leave = 1;
+    for (const auto& [direction, distance] : boundaries) {
+        if (direction == 0) {
+            if (distance < 0) {
+                return false;
+            }
+            continue;
+        }
+
+        const auto t = distance / direction;
+        if (direction < 0) {
+            enter = std::max(enter, t);
+        } else {
+            leave = std::min(leave, t);
+        }
+
+        if (enter > leave) {
+            return false;
+        }
+    }
+
+    line = QLineF(line.pointAt(enter), line.pointAt(leave));
+    return true;
+}
+
+// Clips the edge from start to end to the area, unless it is shorter than minLength.
+static void addSegment(QPoint start, QPoint end, const QRectF& clipRect, int minLength,
+                       std::vector<QLineF>& segments) {
+    if ((end - start).manhattanLength() < minLength) {
+        return;
+    }
+
+    QLineF line(start, end);
+    if (clipLine(line, clipRect)) {
+        segments.push_back(line);
+    }
+}
+
+EdgeSegmentIndex::EdgeSegmentIndex(const IGraphStorage& storage, std::span<const QPoint> positions,
+                                   const std::vector<bool>& removedNodes) {
+    const auto isRemoved = [&](NodeIndex_t index) {
+        return index < removedNodes.size() && removedNodes[index];
+    };
+
+    const auto forEachDrawnEdge = [&](NodeIndex_t node, auto&& callback) {
+        if (isRemoved(node)) {
+            return;
+        }
+
+        forEachUniqueNeighbour(storage, node, [&](NodeIndex_t neighbour, CostType_t) {
+            if (neighbour != node && !isRemoved(neighbour)) {
+                callback(neighbour);
+            }
+        });
+    };
+
+    // Counting the edges first lets every node write its own in place.
+    std::vector<size_t> offsets(positions.size() + 1, 0);
+    const auto nodeCount = static_cast<NodeIndex_t>(positions.size());
+    const auto nodes = std::views::iota(NodeIndex_t{0}, nodeCount);
+    std::for_each(std::execution::par, nodes.begin(), nodes.end(), [&](NodeIndex_t node) {
+        forEachDrawnEdge(node, [&](NodeIndex_t) { ++offsets[node + 1]; });
+    });
+    std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<Entry_t> entries(offsets.back());
+    std::for_each(std::execution::par, nodes.begin(), nodes.end(), [&](NodeIndex_t node) {
+        auto entry = offsets[node];
+        forEachDrawnEdge(node,
+                         [&](NodeIndex_t neighbour) { entries[entry++] = {0, node, neighbour}; });
+    });
+
+    m_grid = buildGrid({positions.begin(), positions.end()}, std::move(entries));
+}
+
+std::shared_ptr<const EdgeSegmentIndex> EdgeSegmentIndex::patched(
+    std::span<const NodePair_t> changedEdges, std::span<const Segment_t> segments) const {
+    std::vector<uint64_t> newChanges;
+    newChanges.reserve(changedEdges.size());
+    for (const auto& [start, end] : changedEdges) {
+        newChanges.push_back(getPairKey(start, end));
+    }
+    std::ranges::sort(newChanges);
+    newChanges.erase(std::ranges::unique(newChanges).begin(), newChanges.end());
+
+    std::shared_ptr<EdgeSegmentIndex> index(new EdgeSegmentIndex);
+    index->m_grid = m_grid;
+
+    index->m_changedEdges.reserve(m_changedEdges.size() + newChanges.size());
+    std::ranges::set_union(m_changedEdges, newChanges, std::back_inserter(index->m_changedEdges));
+
+    // The earlier segments of pairs changed again are replaced.
+    index->m_segments.reserve(m_segments.size() + segments.size());
+    std::ranges::copy_if(m_segments, std::back_inserter(index->m_segments),
+                         [&](const Segment_t& segment) {
+                             const auto& [start, end] = segment.m_nodes;
+                             return !std::ranges::binary_search(newChanges,
+                                                                getPairKey(start, end));
+                         });
+    std::ranges::copy(segments, std::back_inserter(index->m_segments));
+
+    return index;
+}
+
+bool EdgeSegmentIndex::needsCompaction() const {
+    return m_changedEdges.size() > k_maxChangedEdges;
+}
+
+std::shared_ptr<const EdgeSegmentIndex> EdgeSegmentIndex::compacted() const {
+    // Segments hold the latest positions of their nodes, the grid those it was built with.
+    auto positions = m_grid->m_positions;
+    for (const auto& [nodes, line] : m_segments) {
+        const auto [start, end] = nodes;
+        positions.resize(std::max<size_t>(positions.size(), std::max(start, end) + 1));
+        positions[start] = line.p1();
+        positions[end] = line.p2();
+    }
+
+    std::vector<Entry_t> entries;
+    entries.reserve(m_grid->m_entries.size() + m_segments.size());
+    std::ranges::copy_if(m_grid->m_entries, std::back_inserter(entries), [&](const Entry_t& entry) {
+        return !isChanged(entry.m_start, entry.m_end);
+    });
+    for (const auto& [nodes, line] : m_segments) {
+        entries.push_back({0, nodes.first, nodes.second});
+    }
+
+    std::shared_ptr<EdgeSegmentIndex> index(new EdgeSegmentIndex);
+    index->m_grid = buildGrid(std::move(positions), std::move(entries));
+    return index;
+}
+
+void EdgeSegmentIndex::getSegmentsInArea(const QRect& area, int minLength,
+                                         std::vector<QLineF>& segments) const {
+    const QRectF clipRect(area);
+    const auto& [positions, entries, levelBegins] = *m_grid;
+
+    for (int level = 0; level < k_levelCount; ++level) {
+        const auto cellSize = k_baseCellSize << level;
+        const auto begin = entries.begin() + levelBegins[level];
+        const auto end = entries.begin() + levelBegins[level + 1];
+
+        // Edges of this level are at most two cells long in manhattan length.
+        if (begin == end || 2 * cellSize < minLength) {
+            continue;
+        }
+
+        // An edge is keyed by the top left of its bounding box, which may lie one
+        // cell before the area while the edge still reaches into it. The far sides
+        // are those of clipRect, one unit past area.right() and area.bottom().
+        const auto top = floorDiv(area.top(), cellSize) - 1;
+        const auto bottom = floorDiv(int64_t{area.top()} + area.height(), cellSize);
+        const auto right = floorDiv(int64_t{area.left()} + area.width(), cellSize);
+
+        for (auto x = floorDiv(area.left(), cellSize) - 1; x <= right; ++x) {
+            const auto lastKey = getKey(level, x, bottom);
+            auto it = std::ranges::lower_bound(begin, end, getKey(level, x, top), {},
+                                               &Entry_t::m_key);
+
+            for (; it != end && it->m_key <= lastKey; ++it) {
+                if (!isChanged(it->m_start, it->m_end)) {
+                    addSegment(positions[it->m_start], positions[it->m_end], clipRect, minLength,
+                               segments);
+                }
+            }
+        }
+    }
+
+    for (const auto& [nodes, line] : m_segments) {
+        addSegment(line.p1(), line.p2(), clipRect, minLength, segments);
+    }
+}
+
+uint64_t EdgeSegmentIndex::getKey(int level, int64_t x, int64_t y) {
+    constexpr auto bias = int64_t{1} << (k_cellBits - 1);
+    return uint64_t(level) << k_levelShift | uint64_t(x + bias) << k_cellBits | uint64_t(y + bias);
+}
+
+uint64_t EdgeSegmentIndex::getPairKey(NodeIndex_t start, NodeIndex_t end) {
+    return uint64_t{std::min(start, end)} << 32 | std::max(start, end);
+}
+
+std::shared_ptr<const EdgeSegmentIndex::Grid_t> EdgeSegmentIndex::buildGrid(
+    std::vector<QPoint> positions, std::vector<Entry_t> entries) {
+    auto grid = std::make_shared<Grid_t>();
+    grid->m_positions = std::move(positions);
+    grid->m_entries = std::move(entries);
+
+    std::for_each(std::execution::par, grid->m_entries.begin(), grid->m_entries.end(),
+                  [&](Entry_t& entry) {
+                      const auto start = grid->m_positions[entry.m_start];
+                      const auto end = grid->m_positions[entry.m_end];
+
+                      const auto extent = std::max(std::abs(int64_t{end.x()} - start.x()),
+                                                   std::abs(int64_t{end.y()} - start.y()));
+                      const auto level = std::min(
+                          extent <= k_baseCellSize
+                              ? 0
+                              : static_cast<int>(std::bit_width(static_cast<uint64_t>(
+                                    (extent - 1) / k_baseCellSize))),
+                          k_levelCount - 1);
+
+                      const auto cellSize = k_baseCellSize << level;
+                      const auto x = floorDiv(std::min(start.x(), end.x()), cellSize);
+                      const auto y = floorDiv(std::min(start.y(), end.y()), cellSize);
+                      entry.m_key = getKey(level, x, y);
+                  });
+
+    std::sort(std::execution::par, grid->m_entries.begin(), grid->m_entries.end(),
+              [](const Entry_t& a, const Entry_t& b) { return a.m_key < b.m_key; });
+
+    for (int level = 0; level <= k_levelCount; ++level) {
+        const auto levelKey = uint64_t(level) << k_levelShift;
+        grid->m_levelBegins[level] = static_cast<size_t>(
+            std::ranges::lower_bound(grid->m_entries, levelKey, {}, &Entry_t::m_key) -
+            grid->m_entries.begin());
+    }
+
+    return grid;
+}
+
+bool EdgeSegmentIndex::isChanged(NodeIndex_t start, NodeIndex_t end) const {
+    return !m_changedEdges.empty() &&
+           std::ranges::binary_search(m_changedEdges, getPairKey(start, end));
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "storage/IGraphStorage.h"
+
+#include "Node.h"
+
+/**
+ * @class EdgeSegmentIndex
+ * @brief Snapshot of the drawn edges as line segments, indexed by their bounding boxes.
+ *
+ * Storage Format:
+ * - m_grid:          the bulk of the edges, shared by every patched copy
+ *   - m_positions:   node positions at the time the grid was built
+ *   - m_entries:     every edge once, sorted by a key made of its level and the
+ *                    cell holding the top left corner of its bounding box
+ *   - m_levelBegins: first entry of every level, followed by the end
+ * - m_changedEdges:  sorted keys of the node pairs whose grid entries are hidden
+ * - m_segments:      current segments of the changed pairs that are still drawn
+ *
+ * Cells of level L are k_baseCellSize << L wide, and an edge goes to the lowest
+ * level whose cells are at least as wide as its bounding box, so it overlaps at
+ * most 2x2 of them. Area queries look at the cells of every level overlapping
+ * the area grown by one cell to the top left, with one binary search per cell
+ * column, which finds edges crossing the area even when both ends lie far
+ * outside of it. Levels of edges too short to show are skipped entirely.
+ *
+ * Edits don't rebuild the grid: patched() hides the grid entries of the changed
+ * pairs and keeps their new segments aside, where queries scan them linearly.
+ * Once those grow past k_maxChangedEdges, compacted() folds them into a new
+ * grid. An edge is known by its two nodes, in either order.
+ *
+ * Nothing refers back to the graph once built and an index never changes, so
+ * it can be read, and compacted, on worker threads while the graph keeps
+ * changing on the GUI thread.
+ */
+class EdgeSegmentIndex {
+   public:
+    using NodePair_t = std::pair<NodeIndex_t, NodeIndex_t>;
+
+    // The line runs from the first node of the pair to the second.
+    struct Segment_t {
+        NodePair_t m_nodes;
+        QLine m_line;
+    };
+
+    // Loops and the edges of nodes flagged in removedNodes are left out.
+    EdgeSegmentIndex(const IGraphStorage& storage, std::span<const QPoint> positions,
+                     const std::vector<bool>& removedNodes);
+
+    // Copy in which the edges between changedEdges are drawn as segments, which
+    // holds one entry for each of those pairs that is still drawn.
+    std::shared_ptr<const EdgeSegmentIndex> patched(std::span<const NodePair_t> changedEdges,
+                                                    std::span<const Segment_t> segments) const;
+    bool needsCompaction() const;
+    // Copy with the patches folded into a new grid.
+    std::shared_ptr<const EdgeSegmentIndex> compacted() const;
+
+    // Appends the edges crossing the area, clipped to it. Edges whose ends are
+    // less than minLength apart (in manhattan length) are left out.
+    void getSegmentsInArea(const QRect& area, int minLength, std::vector<QLineF>& segments) const;
+
+   private:
+    struct Entry_t {
+        uint64_t m_key;
+        NodeIndex_t m_start;
+        NodeIndex_t m_end;
+    };
+
+    static constexpr int64_t k_baseCellSize{64};
+    // Enough for edges spanning any scene that fits in an int.
+    static constexpr int k_levelCount{26};
+
+    struct Grid_t {
+        std::vector<QPoint> m_positions;
+        std::vector<Entry_t> m_entries;
+        std::array<size_t, k_levelCount + 1> m_levelBegins{};
+    };
+
+    // Keys hold the level in the top bits, then the biased cell coordinates.
+    static constexpr int k_cellBits{29};
+    static constexpr int k_levelShift{2 * k_cellBits};
+    static uint64_t getKey(int level, int64_t x, int64_t y);
+    static uint64_t getPairKey(NodeIndex_t start, NodeIndex_t end);
+
+    // Fills in the keys of the entries, which only need their nodes, and sorts them.
+    static std::shared_ptr<const Grid_t> buildGrid(std::vector<QPoint> positions,
+                                                   std::vector<Entry_t> entries);
+
+    EdgeSegmentIndex() = default;
+
+    bool isChanged(NodeIndex_t start, NodeIndex_t end) const;
+
+    std::shared_ptr<const Grid_t> m_grid;
+    std::vector<uint64_t> m_changedEdges{};
+    std::vector<Segment_t> m_segments{};
+
+    static constexpr size_t k_maxChangedEdges{16'384};
+};
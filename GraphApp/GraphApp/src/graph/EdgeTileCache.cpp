@@ -0,0 +1,143 @@
+#include <pch.h>
+
+#include "EdgeTileCache.h"
+
+static int floorDiv(int value, int divisor) {
+    return value >= 0 ? value / divisor : (value + 1) / divisor - 1;
+}
+
+EdgeTileCache::EdgeTileCache(QObject* context, std::function<void(const QRect&)> onTileReady)
+    : m_context(context), m_onTileReady(std::move(onTileReady)) {}
+
+// Workers check m_clearedRequestId, so they have to be done before the cache goes away.
+EdgeTileCache::~EdgeTileCache() { m_threadPool.waitForDone(); }
+
+void EdgeTileCache::draw(QPainter* painter, const QRect& area, qreal lod, const QPen& pen,
+                         const PathRequest_t& requestPath) {
+    if (pen != m_pen) {
+        clear();
+        m_pen = pen;
+    }
+
+    const auto level = getLevel(lod);
+    const auto span = getTileRect({level, 0, 0}).width();
+    const auto half = k_tileSize / 2;
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+
+    for (int y = floorDiv(area.top(), span); y <= floorDiv(area.bottom(), span); ++y) {
+        for (int x = floorDiv(area.left(), span); x <= floorDiv(area.right(), span); ++x) {
+            const TileKey_t key{level, x, y};
+            const auto rect = getTileRect(key);
+
+            if (const auto image = find(key)) {
+                painter->drawImage(rect, *image);
+                continue;
+            }
+
+            request(key, requestPath);
+
+            const TileKey_t parent{level - 1, floorDiv(x, 2), floorDiv(y, 2)};
+            if (const auto image = level > k_minLevel ? find(parent) : nullptr) {
+                const QRect source{(x - 2 * parent.m_x) * half, (y - 2 * parent.m_y) * half, half,
+                                   half};
+                painter->drawImage(rect, *image, source);
+            }
+        }
+    }
+
+    painter->restore();
+}
+
+void EdgeTileCache::invalidate(const QRect& area) {
+    for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+        it = getTileRect(it->first).intersects(area) ? m_tiles.erase(it) : std::next(it);
+    }
+
+    for (auto it = m_pendingTiles.begin(); it != m_pendingTiles.end();) {
+        it = getTileRect(it->first).intersects(area) ? m_pendingTiles.erase(it) : std::next(it);
+    }
+}
+
+void EdgeTileCache::clear() {
+    m_clearedRequestId = m_lastRequestId;
+    m_tiles.clear();
+    m_pendingTiles.clear();
+}
+
+int EdgeTileCache::getLevel(qreal lod) {
+    return std::clamp(static_cast<int>(std::round(std::log2(lod))), k_minLevel, 0);
+}
+
+QRect EdgeTileCache::getTileRect(const TileKey_t& key) {
+    const auto span = k_tileSize << -key.m_level;
+    return QRect(key.m_x * span, key.m_y * span, span, span);
+}
+
+const QImage* EdgeTileCache::find(const TileKey_t& key) {
+    const auto it = m_tiles.find(key);
+    if (it == m_tiles.end()) {
+        return nullptr;
+    }
+
+    it->second.m_lastUsed = ++m_useCounter;
+    return &it->second.m_image;
+}
+
+void EdgeTileCache::request(const TileKey_t& key, const PathRequest_t& requestPath) {
+    if (m_pendingTiles.contains(key)) {
+        return;
+    }
+
+    const auto requestId = ++m_lastRequestId;
+    m_pendingTiles[key] = requestId;
+
+    const auto area = getTileRect(key);
+    const auto scale = std::ldexp(1., key.m_level);
+
+    QtConcurrent::run(&m_threadPool,
+                      [this, buildPath = requestPath(area), requestId, area, scale, pen = m_pen]() {
+                          // Cleared while queued, store() would throw the tile away anyway.
+                          if (requestId <= m_clearedRequestId) {
+                              return QImage{};
+                          }
+
+                          const auto path = buildPath();
+
+                          QImage image(k_tileSize, k_tileSize, QImage::Format_ARGB32_Premultiplied);
+                          image.fill(Qt::transparent);
+
+                          QPainter painter(&image);
+                          painter.setRenderHint(QPainter::Antialiasing);
+                          painter.scale(scale, scale);
+                          painter.translate(-area.topLeft());
+                          painter.setPen(pen);
+                          painter.setBrush(Qt::NoBrush);
+                          painter.drawPath(path);
+
+                          return image;
+                      })
+        .then(m_context, [this, key, requestId](QImage image) {
+            store(key, requestId, std::move(image));
+        });
+}
+
+void EdgeTileCache::store(const TileKey_t& key, uint64_t requestId, QImage image) {
+    // The tile got invalidated or cleared while it was rendering.
+    const auto pending = m_pendingTiles.find(key);
+    if (pending == m_pendingTiles.end() || pending->second != requestId) {
+        return;
+    }
+
+    m_pendingTiles.erase(pending);
+    m_tiles[key] = {std::move(image), ++m_useCounter};
+
+    if (m_tiles.size() > k_maxTiles) {
+        m_tiles.erase(std::ranges::min_element(m_tiles, {}, [](const auto& tile) {
+            return tile.second.m_lastUsed;
+        }));
+    }
+
+    m_onTileReady(getTileRect(key));
+}
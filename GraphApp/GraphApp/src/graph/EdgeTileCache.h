@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @class EdgeTileCache
+ * @brief Edges rasterized into fixed size images, for drawing zoomed out views.
+ *
+ * Storage Format:
+ * - m_tiles:        rendered tiles, keyed by level and tile coordinates
+ * - m_pendingTiles: tiles being rendered, with the id of the latest request
+ *
+ * Level L draws the scene at scale 2^L, so one of its tiles covers
+ * k_tileSize << -L scene units with k_tileSize pixels. Painting picks the level
+ * nearest to the view's zoom and blits its tiles; a tile that isn't ready yet
+ * is stood in for by its part of the coarser tile above it, if that is cached.
+ *
+ * Missing tiles are rendered on worker threads. The caller collects what a tile
+ * needs on the GUI thread and hands back a function building its edge path,
+ * which runs on the worker together with the rasterization, so it must only
+ * read data the GUI thread won't change under it. Invalidating an
+ * area drops the tiles and the pending requests touching it; results of
+ * dropped requests are thrown away when they arrive, and clearing skips the
+ * requests that haven't started yet.
+ *
+ * At most k_maxTiles are kept, the least recently drawn ones are evicted first.
+ */
+class EdgeTileCache {
+   public:
+    using PathBuilder_t = std::function<QPainterPath()>;
+    // Called on the GUI thread for a tile's scene area, the builder runs on a worker.
+    using PathRequest_t = std::function<PathBuilder_t(const QRect& area)>;
+
+    static constexpr int k_tileSize{256};
+
+    EdgeTileCache(QObject* context, std::function<void(const QRect&)> onTileReady);
+    ~EdgeTileCache();
+
+    // Draws the tiles covering the area with the pen, requesting the missing ones.
+    void draw(QPainter* painter, const QRect& area, qreal lod, const QPen& pen,
+              const PathRequest_t& requestPath);
+
+    void invalidate(const QRect& area);
+    void clear();
+
+   private:
+    struct TileKey_t {
+        int m_level;
+        int m_x;
+        int m_y;
+
+        auto operator<=>(const TileKey_t&) const = default;
+    };
+
+    struct Tile_t {
+        QImage m_image;
+        uint64_t m_lastUsed;
+    };
+
+    static int getLevel(qreal lod);
+    static QRect getTileRect(const TileKey_t& key);
+
+    const QImage* find(const TileKey_t& key);
+    void request(const TileKey_t& key, const PathRequest_t& requestPath);
+    void store(const TileKey_t& key, uint64_t requestId, QImage image);
+
+    QObject* m_context;
+    std::function<void(const QRect&)> m_onTileReady;
+
+    std::map<TileKey_t, Tile_t> m_tiles{};
+    std::map<TileKey_t, uint64_t> m_pendingTiles{};
+    uint64_t m_lastRequestId{0};
+    std::atomic<uint64_t> m_clearedRequestId{0};
+    uint64_t m_useCounter{0};
+
+    QPen m_pen{};
+    QThreadPool m_threadPool{};
+
+    static constexpr int k_minLevel{-10};
+    static constexpr size_t k_maxTiles{256};
+};
@@ -2,6 +2,8 @@
 
 #include "Graph.h"
 
+#include "storage/ImplicitCompleteGraph.h"
+
 Graph::Graph(QWidget* parent) : QGraphicsView(parent), m_scene(new QGraphicsScene()) {
     setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
     setFrameStyle(QFrame::NoFrame);
@@ -79,7 +81,22 @@ bool Graph::buildFromAdjacencyListString(const QString& text) {
     m_graphManager.resetAdjacencyMatrix();
     m_graphManager.resizeAdjacencyMatrix(m_graphManager.getNodesCount());
 
-    m_graphManager.evaluateStorageStrategy(lines.size());
+    CostType_t minCost = 0, maxCost = 0;
+    for (const QString& line : lines) {
+        const auto parts = line.split(' ', Qt::SkipEmptyParts);
+        if (parts.size() >= 3) {
+            const auto cost = parts[2].toInt();
+            minCost = std::min(minCost, cost);
+            maxCost = std::max(maxCost, cost);
+        }
+    }
+    m_graphManager.evaluateStorageStrategy(lines.size(), minCost, maxCost);
+
+    std::vector<IGraphStorage::Edge_t> edges;
+    edges.reserve(m_graphManager.getOrientedGraph() ? lines.size() : 2 * lines.size());
+
+    std::unordered_set<uint64_t> addedEdges;
+    auto encode = [](NodeIndex_t u, NodeIndex_t v) -> uint64_t { return (uint64_t(u) << 32) | v; };
 
     for (QString& line : lines) {
         line = line.trimmed();
@@ -117,7 +134,7 @@ bool Graph::buildFromAdjacencyListString(const QString& text) {
                 return false;
             }
 
-            if (m_graphManager.hasNeighbour(u, v)) {
+            if (addedEdges.contains(encode(u, v))) {
                 QMessageBox::warning(nullptr, "Duplicate edge",
                                      QString("Edge from %1 to %2 already exists!").arg(u).arg(v));
                 return false;
@@ -130,7 +147,7 @@ bool Graph::buildFromAdjacencyListString(const QString& text) {
             }
 
             if (!m_graphManager.getOrientedGraph()) {
-                if (m_graphManager.hasNeighbour(v, u)) {
+                if (addedEdges.contains(encode(v, u))) {
                     QMessageBox::warning(nullptr, "Duplicate edge",
                                          QString("Edge from %1 to %2 already exists!\nBecause this "
                                                  "is an unoriented graph")
@@ -140,13 +157,16 @@ bool Graph::buildFromAdjacencyListString(const QString& text) {
                 }
             }
 
-            m_graphManager.addEdge(u, v, cost);
+            edges.push_back({u, v, cost});
+            addedEdges.insert(encode(u, v));
             if (!m_graphManager.getOrientedGraph()) {
-                m_graphManager.addEdge(v, u, cost);
+                edges.push_back({v, u, cost});
+                addedEdges.insert(encode(v, u));
             }
         }
     }
 
+    m_graphManager.addEdges(edges);
     return true;
 }
 
@@ -173,7 +193,14 @@ void Graph::setSceneSize(QSize size) {
 
 QSize Graph::getSceneSize() const { return m_scene->sceneRect().size().toSize(); }
 
-Graph* Graph::getInvertedGraph() const {
+void Graph::loadBinaryGraph(const QString& filePath) {
+    m_graphManager.loadBinaryGraph(filePath);
+    m_scene->setSceneRect(m_graphManager.m_boundingRect);
+}
+
+Graph* Graph::getInvertedGraph() {
+    m_graphManager.compactRemovedNodes();
+
     if (m_graphManager.getNodesCount() == 0) {
         QMessageBox::warning(nullptr, "Error", "Cannot invert a graph without nodes.",
                              QMessageBox::Ok);
@@ -195,7 +222,7 @@ Graph* Graph::getInvertedGraph() const {
 
     auto& invertedGraphManager = invertedGraph->m_graphManager;
     invertedGraphManager.setSceneDimensions(m_scene->sceneRect().size().toSize());
-    invertedGraphManager.setGraphStorageType(m_graphManager.getGraphStorage()->type());
+    invertedGraphManager.setGraphStorageType(m_graphManager.getThawedGraphStorageType());
 
     invertedGraphManager.setAllowEditing(m_graphManager.getAllowEditing());
     invertedGraphManager.setAllowLoops(m_graphManager.getAllowLoops());
@@ -203,17 +230,29 @@ Graph* Graph::getInvertedGraph() const {
     invertedGraphManager.setDrawEdgesEnabled(m_graphManager.getDrawEdgesEnabled());
 
     invertedGraphManager.setCollisionsCheckEnabled(false);
-    for (const auto& node : m_graphManager.m_nodes) {
-        invertedGraphManager.addNode(node.getPosition());
-    }
+    invertedGraphManager.addNodes(m_graphManager.m_nodes.getPositions());
     invertedGraphManager.setCollisionsCheckEnabled(true);
 
     invertedGraphManager.resizeAdjacencyMatrix(m_graphManager.m_nodes.size());
-    for (NodeIndex_t nodeIndex = 0; nodeIndex < m_graphManager.m_nodes.size(); ++nodeIndex) {
-        m_graphManager.m_graphStorage->forEachOutgoingEdgeWithOpposites(
-            nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
-                invertedGraphManager.addEdge(neighbourIndex, nodeIndex, cost);
-            });
+    if (m_graphManager.m_graphStorage->type() == IGraphStorage::Type::COMPLETE_GRAPH) {
+        // Transposing only touches the edited edges instead of enumerating n^2 of them.
+        invertedGraphManager.m_graphStorage =
+            static_cast<const ImplicitCompleteGraph&>(*m_graphManager.m_graphStorage).transposed();
+    } else {
+        // One bulk insert, which a frozen complete graph also turns back into a clique.
+        std::vector<IGraphStorage::Edge_t> edges;
+        for (NodeIndex_t nodeIndex = 0; nodeIndex < m_graphManager.m_nodes.size(); ++nodeIndex) {
+            m_graphManager.m_graphStorage->forEachOutgoingEdgeWithOpposites(
+                nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
+                    edges.push_back({neighbourIndex, nodeIndex, cost});
+                });
+        }
+
+        invertedGraphManager.addEdges(edges);
+    }
+
+    if (m_graphManager.isGraphStorageFrozen()) {
+        invertedGraphManager.freezeGraphStorage();
     }
 
     return invertedGraph;
@@ -18,8 +18,10 @@ class Graph : public QGraphicsView {
 
     void setSceneSize(QSize size);
     QSize getSceneSize() const;
+    void loadBinaryGraph(const QString& filePath);
 
-    Graph* getInvertedGraph() const;
+    // Compacts the removed nodes away first, the inverted graph gets the same indices.
+    Graph* getInvertedGraph();
 
     void notifyLeftArrowPressed();
     void notifyRightArrowPressed();
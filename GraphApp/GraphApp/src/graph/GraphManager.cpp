@@ -2,14 +2,24 @@
 
 #include "GraphManager.h"
 
+#include "BinaryGraphFormat.h"
+#include "NodeOrdering.h"
+
 #include "storage/AdjacencyList.h"
 #include "storage/AdjacencyMatrix.h"
+#include "storage/BitMatrix.h"
+#include "storage/CompressedSparseRow.h"
+#include "storage/CompressedVarintRow.h"
+#include "storage/ImplicitCompleteGraph.h"
+#include "storage/GraphStorageVisitor.h"
 
 #include "algorithms/IAlgorithm.h"
 
 #include "../random/Random.h"
 
-GraphManager::GraphManager() : m_graphStorage(std::make_unique<AdjacencyList>()) {
+GraphManager::GraphManager()
+    : m_graphStorage(std::make_unique<AdjacencyList<int8_t>>()),
+      m_edgeTiles(this, [this](const QRect& rect) { invalidate(rect); }) {
     setFlag(ItemIsFocusable);
 
     connect(&m_edgeWatcher, &QFutureWatcher<QPainterPath>::finished, [this]() {
@@ -18,25 +28,54 @@ GraphManager::GraphManager() : m_graphStorage(std::make_unique<AdjacencyList>())
             update();
         }
     });
+
+    m_invalidateTimer.setSingleShot(true);
+    m_invalidateTimer.setInterval(k_invalidateIntervalMs);
+    connect(&m_invalidateTimer, &QTimer::timeout, [this]() {
+        update(m_invalidatedRect);
+        m_invalidatedRect = {};
+    });
 }
 
 void GraphManager::setGraphStorageType(IGraphStorage::Type type) {
-    switch (type) {
-        case IGraphStorage::Type::ADJACENCY_LIST:
-            m_graphStorage = std::make_unique<AdjacencyList>();
-            break;
-        case IGraphStorage::Type::ADJACENCY_MATRIX:
-            m_graphStorage = std::make_unique<AdjacencyMatrix>();
-            break;
-        default:
-            throw std::runtime_error("Unknown graph storage type.");
-    }
+    // Storages start with the narrowest costs, addEdge widens them when needed.
+    m_graphStorage = createGraphStorage(type, IGraphStorage::CostWidth::INT8);
 }
 
 const std::unique_ptr<IGraphStorage>& GraphManager::getGraphStorage() const {
     return m_graphStorage;
 }
 
+void GraphManager::freezeGraphStorage() {
+    if (isGraphStorageFrozen()) {
+        return;
+    }
+
+    m_thawedStorageType = m_graphStorage->type();
+    m_thawedCostWidth = m_graphStorage->costWidth();
+    convertGraphStorage(m_nodes.size() >= COMPRESSED_STORAGE_NODE_THRESHOLD
+                            ? IGraphStorage::Type::COMPRESSED_VARINT_ROW
+                            : IGraphStorage::Type::COMPRESSED_SPARSE_ROW,
+                        m_thawedCostWidth);
+}
+
+void GraphManager::thawGraphStorage() {
+    if (!isGraphStorageFrozen()) {
+        return;
+    }
+
+    convertGraphStorage(m_thawedStorageType, m_thawedCostWidth);
+}
+
+bool GraphManager::isGraphStorageFrozen() const {
+    return m_graphStorage->type() == IGraphStorage::Type::COMPRESSED_SPARSE_ROW ||
+           m_graphStorage->type() == IGraphStorage::Type::COMPRESSED_VARINT_ROW;
+}
+
+IGraphStorage::Type GraphManager::getThawedGraphStorageType() const {
+    return isGraphStorageFrozen() ? m_thawedStorageType : m_graphStorage->type();
+}
+
 void GraphManager::setSceneDimensions(QSize size) {
     m_boundingRect.setCoords(0, 0, size.width(), size.height());
     m_quadTree.setBoundary(QRect(0, 0, size.width(), size.height()));
@@ -61,7 +100,11 @@ void GraphManager::reset() {
     m_nodes.clear();
     m_quadTree.clear();
     m_edgeCache.clear();
+    m_edgeTiles.clear();
+    dropEdgeSegments();
     m_selectedNodes.clear();
+    m_removedNodes.clear();
+    m_removedNodesCount = 0;
 
     resetAdjacencyMatrix();
 }
@@ -72,7 +115,7 @@ size_t GraphManager::getSelectedNodesCount() const { return m_selectedNodes.size
 
 void GraphManager::reserveNodes(size_t count) { m_nodes.reserve(count); }
 
-NodeData& GraphManager::getNode(NodeIndex_t index) { return m_nodes[index]; }
+NodeData GraphManager::getNode(NodeIndex_t index) { return m_nodes[index]; }
 
 std::optional<NodeIndex_t> GraphManager::getNode(const QPoint& pos, float minDistance) {
     return m_quadTree.getNodeAtPosition(pos, minDistance);
@@ -105,6 +148,24 @@ bool GraphManager::hasNeighbour(NodeIndex_t index, NodeIndex_t neighbour) const
     return m_graphStorage->getEdge(index, neighbour).has_value();
 }
 
+void GraphManager::resetNodeStates(NodeData::State state, QRgb fillColor) {
+    m_nodes.resetStates(state, fillColor);
+    invalidate(m_sceneRect);
+}
+
+void GraphManager::invalidate(const QRect& rect) {
+    // Whatever is outside the view gets repainted by Qt once it is scrolled in.
+    const auto visibleRect = rect.intersected(m_sceneRect);
+    if (visibleRect.isEmpty()) {
+        return;
+    }
+
+    m_invalidatedRect = m_invalidatedRect.united(visibleRect);
+    if (!m_invalidateTimer.isActive()) {
+        m_invalidateTimer.start();
+    }
+}
+
 bool GraphManager::addNode(const QPoint& pos) {
     if (m_nodes.size() > NODE_LIMIT) {
         throw std::runtime_error("Cannot add more nodes: limit reached.");
@@ -114,36 +175,121 @@ bool GraphManager::addNode(const QPoint& pos) {
         return false;
     }
 
-    auto& lastNode = m_nodes.emplace_back(m_nodes.size(), pos);
-    lastNode.setFillColor(m_nodeDefaultColor);
-
+    const auto lastNode = m_nodes.add(pos, m_nodeDefaultColor);
     m_quadTree.insert(lastNode);
 
-    update(lastNode.getBoundingRect());
+    invalidate(lastNode.getBoundingRect());
     return true;
 }
 
+void GraphManager::addNodes(std::span<const QPoint> positions) {
+    if (positions.size() < k_bulkInsertThreshold) {
+        for (const auto& position : positions) {
+            addNode(position);
+        }
+
+        return;
+    }
+
+    if (m_nodes.size() + positions.size() > NODE_LIMIT) {
+        throw std::runtime_error("Cannot add more nodes: limit reached.");
+    }
+
+    // The nodes already in the graph are checked against in parallel.
+    std::vector<uint8_t> accepted(positions.size());
+    const auto indices = std::views::iota(size_t{0}, positions.size());
+    std::for_each(std::execution::par, indices.begin(), indices.end(),
+                  [&](size_t i) { accepted[i] = isGoodPosition(positions[i]); });
+
+    // The batch itself is checked in order. Accepted positions are at least a node
+    // diameter apart, so a grid of cells that wide holds only a few per cell.
+    if (m_collisionsCheckEnabled) {
+        constexpr auto diameter = 2 * NodeData::k_radius;
+        const auto getCellKey = [](int x, int y) {
+            return uint64_t{static_cast<uint32_t>(x)} << 32 | static_cast<uint32_t>(y);
+        };
+
+        std::unordered_map<uint64_t, std::vector<QPoint>> acceptedCells;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            if (!accepted[i]) {
+                continue;
+            }
+
+            // Accepted positions lie inside the scene, so the cells are never negative.
+            const auto& position = positions[i];
+            const auto x = position.x() / diameter;
+            const auto y = position.y() / diameter;
+
+            for (auto dx = -1; dx <= 1 && accepted[i]; ++dx) {
+                for (auto dy = -1; dy <= 1 && accepted[i]; ++dy) {
+                    const auto cell = acceptedCells.find(getCellKey(x + dx, y + dy));
+                    if (cell == acceptedCells.end()) {
+                        continue;
+                    }
+
+                    accepted[i] = std::ranges::none_of(cell->second, [&](const QPoint& other) {
+                        const int64_t distanceX = other.x() - position.x();
+                        const int64_t distanceY = other.y() - position.y();
+                        return distanceX * distanceX + distanceY * distanceY <
+                               int64_t{diameter} * diameter;
+                    });
+                }
+            }
+
+            if (accepted[i]) {
+                acceptedCells[getCellKey(x, y)].push_back(position);
+            }
+        }
+    }
+
+    m_nodes.reserve(m_nodes.size() + positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (accepted[i]) {
+            m_nodes.add(positions[i], m_nodeDefaultColor);
+        }
+    }
+
+    recomputeQuadTree();
+    update(m_sceneRect);
+}
+
 void GraphManager::addEdge(NodeIndex_t start, NodeIndex_t end, int32_t cost) {
-    if (m_graphStorage->type() == IGraphStorage::Type::ADJACENCY_MATRIX) {
-        constexpr auto numBits = sizeof(CostType_t) * 8 - 1;
-        constexpr auto maxCost = (1 << (numBits - 1)) - 1;
-        constexpr auto minCost = -(1 << (numBits - 1));
+    thawGraphStorage();
+    widenCostsToFit(cost, cost);
 
-        cost = std::clamp(cost, minCost, maxCost);
-    } else if (m_graphStorage->type() == IGraphStorage::Type::ADJACENCY_LIST) {
-        constexpr auto maxCost = std::numeric_limits<CostType_t>::max();
-        constexpr auto minCost = std::numeric_limits<CostType_t>::min();
+    m_graphStorage->addEdge(start, end, clampEdgeCost(cost));
+}
+
+void GraphManager::addEdges(std::span<IGraphStorage::Edge_t> edges) {
+    thawGraphStorage();
 
-        cost = std::clamp(cost, minCost, maxCost);
+    if (!edges.empty()) {
+        const auto [minEdge, maxEdge] =
+            std::ranges::minmax_element(edges, {}, &IGraphStorage::Edge_t::m_cost);
+        widenCostsToFit(minEdge->m_cost, maxEdge->m_cost);
     }
 
-    m_graphStorage->addEdge(start, end, cost);
+    for (auto& edge : edges) {
+        edge.m_cost = clampEdgeCost(edge.m_cost);
+    }
+
+    m_graphStorage->addEdges(edges);
+
+    std::vector<EdgeSegmentIndex::NodePair_t> changedEdges;
+    changedEdges.reserve(edges.size());
+    for (const auto& edge : edges) {
+        changedEdges.emplace_back(edge.m_start, edge.m_end);
+    }
+    markEdgesDirty(getEdgesRect(edges), changedEdges);
 }
 
 void GraphManager::randomlyAddEdges(size_t edgeCount) {
     std::unordered_set<uint64_t> used;
     used.reserve(edgeCount * 1.3);
 
+    std::vector<IGraphStorage::Edge_t> edges;
+    edges.reserve(m_orientedGraph ? edgeCount : 2 * edgeCount);
+
     auto encode = [](size_t u, size_t v) -> uint64_t { return (uint64_t(u) << 32) | v; };
 
     while (used.size() < edgeCount) {
@@ -160,13 +306,14 @@ void GraphManager::randomlyAddEdges(size_t edgeCount) {
 
         uint64_t key = encode(u, v);
         if (used.insert(key).second) {
-            addEdge(u, v, 0);
+            edges.push_back({u, v, 0});
             if (!m_orientedGraph) {
-                addEdge(v, u, 0);
+                edges.push_back({v, u, 0});
             }
         }
     }
 
+    addEdges(edges);
     buildEdgeCache();
 }
 
@@ -181,16 +328,31 @@ size_t GraphManager::getMaxEdgesCount() const {
 
 void GraphManager::resizeAdjacencyMatrix(size_t nodeCount) { m_graphStorage->resize(nodeCount); }
 
-void GraphManager::resetAdjacencyMatrix() { m_graphStorage = std::make_unique<AdjacencyList>(); }
+void GraphManager::resetAdjacencyMatrix() {
+    m_graphStorage = std::make_unique<AdjacencyList<int8_t>>();
+}
+
+void GraphManager::markEdgesDirty() {
+    m_edgesDirty = true;
+    m_edgeTiles.clear();
+    dropEdgeSegments();
+}
 
-void GraphManager::markEdgesDirty() { m_edgesDirty = true; }
+void GraphManager::markEdgesDirty(const QRect& rect,
+                                  std::span<const EdgeSegmentIndex::NodePair_t> changedEdges) {
+    m_edgesDirty = true;
+    m_edgeTiles.invalidate(rect);
+    patchEdgeSegments(changedEdges);
+}
 
 void GraphManager::buildEdgeCache() {
     if (!m_drawEdges) {
         return;
     }
 
-    if (!m_edgesDirty && m_edgeCache.m_edgePath.boundingRect().contains(m_sceneRect)) {
+    const auto useEdgeTiles = shouldUseEdgeTiles();
+    if (!m_edgesDirty && m_edgeCache.m_builtForEdgeTiles == useEdgeTiles &&
+        m_edgeCache.m_edgePath.boundingRect().contains(m_sceneRect)) {
         if (m_edgeCache.m_builtWithLod >= 0.5) {
             return;
         }
@@ -209,25 +371,31 @@ void GraphManager::buildEdgeCache() {
     const auto extendedRect = m_sceneRect.adjusted(-halfVisibleWidth, -halfVisibleHeight,
                                                    halfVisibleWidth, halfVisibleHeight);
 
-    std::vector<bool> visitMask(m_nodes.size(), false);
     std::vector<NodeIndex_t> visibleNodes;
-    m_quadTree.getNodesInArea(extendedRect, visitMask, visibleNodes);
+    m_quadTree.getNodesInArea(extendedRect, visibleNodes);
     m_edgesDirty = false;
 
     m_edgeFuture = QtConcurrent::mappedReduced<EdgeCache>(
         visibleNodes,
-        [&](NodeIndex_t nodeIndex) {
+        [&, useEdgeTiles](NodeIndex_t nodeIndex) {
             EdgeCache cache;
             cache.m_builtWithLod = m_currentLod;
+            cache.m_builtForEdgeTiles = useEdgeTiles;
 
             if (m_allowLoops && hasNeighbour(nodeIndex, nodeIndex)) {
                 const auto rect = m_nodes[nodeIndex].getBoundingRect();
                 cache.m_loopEdgePath.addEllipse(rect.adjusted(8, 8, -8, -8));
             }
 
-            m_graphStorage->forEachOutgoingEdge(
-                nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
-                    addEdgeToPath(cache.m_edgePath, nodeIndex, neighbourIndex, cost);
+            if (useEdgeTiles) {
+                return cache;
+            }
+
+            forEachUniqueNeighbour(
+                *m_graphStorage, nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
+                    if (!isNodeRemoved(neighbourIndex)) {
+                        addEdgeToPath(cache.m_edgePath, nodeIndex, neighbourIndex, cost);
+                    }
                 });
 
             return cache;
@@ -236,6 +404,7 @@ void GraphManager::buildEdgeCache() {
             result.m_edgePath.addPath(edgeCache.m_edgePath);
             result.m_loopEdgePath.addPath(edgeCache.m_loopEdgePath);
             result.m_builtWithLod = edgeCache.m_builtWithLod;
+            result.m_builtForEdgeTiles = edgeCache.m_builtForEdgeTiles;
         });
 
     m_edgeWatcher.setFuture(m_edgeFuture);
@@ -246,22 +415,27 @@ void GraphManager::completeGraph() {
         return;
     }
 
-    auto newStorage = std::make_unique<AdjacencyMatrix>();
-    newStorage->resize(m_nodes.size());
-    newStorage->complete();
-    m_graphStorage = std::move(newStorage);
+    m_graphStorage = std::make_unique<ImplicitCompleteGraph>(m_nodes.size(), m_allowLoops);
 
+    markEdgesDirty();
     buildEdgeCache();
 }
 
 void GraphManager::fillGraph() {
     reset();
-    reserveNodes(NODE_LIMIT);
 
     constexpr int padding = 5;
     constexpr int step = 2 * NodeData::k_radius + padding;
+
+    const auto fittingNodes = [](int length) -> size_t {
+        return length < 2 * NodeData::k_radius ? 0 : (length - 2 * NodeData::k_radius) / step + 1;
+    };
+    reserveNodes(std::min(fittingNodes(m_boundingRect.width()) *
+                              fittingNodes(m_boundingRect.height()),
+                          NODE_LIMIT));
     int x = NodeData::k_radius, y = NodeData::k_radius;
 
+    std::vector<QPoint> positions;
     for (size_t i = 0; i < NODE_LIMIT; ++i) {
         if (x + NodeData::k_radius > m_boundingRect.width()) {
             x = NodeData::k_radius;
@@ -272,13 +446,206 @@ void GraphManager::fillGraph() {
             break;
         }
 
-        addNode({x, y});
+        positions.push_back({x, y});
         x += step;
     }
 
+    addNodes(positions);
+
     resizeAdjacencyMatrix(m_nodes.size());
 }
 
+void GraphManager::reorderNodes(NodeOrder order) {
+    // Every node of a complete graph is adjacent to every other one, so there is
+    // no locality to gain and the clique has to stay a prefix of the indices.
+    if (m_nodes.size() < 2 || m_graphStorage->type() == IGraphStorage::Type::COMPLETE_GRAPH) {
+        return;
+    }
+
+    compactRemovedNodes();
+
+    const auto newOrder = [&]() {
+        switch (order) {
+            case NodeOrder::HILBERT_CURVE:
+                return hilbertCurveOrder(m_nodes.getPositions());
+            case NodeOrder::REVERSE_CUTHILL_MCKEE:
+                return reverseCuthillMcKeeOrder(*m_graphStorage, m_nodes.size());
+            case NodeOrder::BREADTH_FIRST:
+                return breadthFirstOrder(*m_graphStorage, m_nodes.size());
+            default:
+                throw std::runtime_error{"Unknown node order."};
+        }
+    }();
+
+    permuteNodes(newOrder);
+}
+
+void GraphManager::saveBinaryGraph(const QString& filePath) {
+    compactRemovedNodes();
+
+    // The storage may still read from the file that is about to be replaced.
+    if (const auto mappedFile = m_mappedGraphFile.lock();
+        mappedFile && QFileInfo{mappedFile->fileName()} == QFileInfo{filePath}) {
+        static_cast<CompressedSparseRow&>(*m_graphStorage).copyExternalArrays();
+    }
+
+    std::unique_ptr<CompressedSparseRow> convertedStorage;
+    if (m_graphStorage->type() != IGraphStorage::Type::COMPRESSED_SPARSE_ROW) {
+        convertedStorage = std::make_unique<CompressedSparseRow>(*m_graphStorage, m_nodes.size());
+    }
+
+    const auto& storage = convertedStorage
+                              ? *convertedStorage
+                              : static_cast<const CompressedSparseRow&>(*m_graphStorage);
+
+    const auto nodePositions = m_nodes.getPositions();
+    std::vector<BinaryGraphPosition_t> positions(nodePositions.size());
+    std::transform(std::execution::par, nodePositions.begin(), nodePositions.end(),
+                   positions.begin(), [](const QPoint& position) {
+                       return BinaryGraphPosition_t{position.x(), position.y()};
+                   });
+
+    BinaryGraphHeader_t header{};
+    header.m_magic = BINARY_GRAPH_MAGIC;
+    header.m_version = BINARY_GRAPH_VERSION;
+    header.m_flags = (m_orientedGraph ? BinaryGraphHeader_t::ORIENTED : 0) |
+                     (m_allowLoops ? BinaryGraphHeader_t::ALLOW_LOOPS : 0) |
+                     (m_drawNodes ? BinaryGraphHeader_t::DRAW_NODES : 0) |
+                     (m_drawEdges ? BinaryGraphHeader_t::DRAW_EDGES : 0) |
+                     (m_editingEnabled ? BinaryGraphHeader_t::ALLOW_EDITING : 0);
+    header.m_sceneWidth = m_boundingRect.width();
+    header.m_sceneHeight = m_boundingRect.height();
+    header.m_storageType = static_cast<uint32_t>(getThawedGraphStorageType());
+    header.m_costWidth = static_cast<uint32_t>(isGraphStorageFrozen()
+                                                   ? m_thawedCostWidth
+                                                   : m_graphStorage->costWidth());
+    header.m_nodeCount = m_nodes.size();
+    header.m_edgeCount = storage.getEdgeCount();
+
+    const auto alignUp = [](uint64_t offset) {
+        return (offset + BINARY_GRAPH_ALIGNMENT - 1) / BINARY_GRAPH_ALIGNMENT *
+               BINARY_GRAPH_ALIGNMENT;
+    };
+
+    header.m_positionsOffset = alignUp(sizeof(BinaryGraphHeader_t));
+    header.m_offsetsOffset =
+        alignUp(header.m_positionsOffset + positions.size() * sizeof(BinaryGraphPosition_t));
+    header.m_targetsOffset =
+        alignUp(header.m_offsetsOffset + storage.getOffsets().size_bytes());
+    header.m_costsOffset = alignUp(header.m_targetsOffset + storage.getTargets().size_bytes());
+
+    QSaveFile file{filePath};
+    if (!file.open(QIODevice::WriteOnly)) {
+        throw std::runtime_error{"Couldn't open the graph file for writing!"};
+    }
+
+    const auto writeSection = [&file](uint64_t offset, std::span<const std::byte> bytes) {
+        constexpr std::array<char, BINARY_GRAPH_ALIGNMENT> padding{};
+        const auto paddingSize = static_cast<qint64>(offset) - file.pos();
+        if (file.write(padding.data(), paddingSize) != paddingSize ||
+            file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size()) !=
+                static_cast<qint64>(bytes.size())) {
+            throw std::runtime_error{"Couldn't write the graph file!"};
+        }
+    };
+
+    writeSection(0, std::as_bytes(std::span{&header, 1}));
+    writeSection(header.m_positionsOffset, std::as_bytes(std::span{positions}));
+    writeSection(header.m_offsetsOffset, std::as_bytes(storage.getOffsets()));
+    writeSection(header.m_targetsOffset, std::as_bytes(storage.getTargets()));
+    writeSection(header.m_costsOffset, std::as_bytes(storage.getCosts()));
+
+    if (!file.commit()) {
+        throw std::runtime_error{"Couldn't write the graph file!"};
+    }
+}
+
+void GraphManager::loadBinaryGraph(const QString& filePath) {
+    auto file = std::make_shared<QFile>(filePath);
+    if (!file->open(QIODevice::ReadOnly)) {
+        throw std::runtime_error{"Couldn't open the graph file!"};
+    }
+
+    const auto fileSize = static_cast<uint64_t>(file->size());
+    if (fileSize < sizeof(BinaryGraphHeader_t)) {
+        throw std::runtime_error{"The graph file is too small!"};
+    }
+
+    const auto* data = file->map(0, file->size());
+    if (!data) {
+        throw std::runtime_error{"Couldn't map the graph file!"};
+    }
+
+    BinaryGraphHeader_t header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.m_magic != BINARY_GRAPH_MAGIC) {
+        throw std::runtime_error{"Not a binary graph file!"};
+    }
+
+    if (header.m_version != BINARY_GRAPH_VERSION) {
+        throw std::runtime_error("Incompatible graph version! Expected version " +
+                                 std::to_string(BINARY_GRAPH_VERSION) + " but got " +
+                                 std::to_string(header.m_version));
+    }
+
+    using enum IGraphStorage::Type;
+
+    const auto thawedType = static_cast<IGraphStorage::Type>(header.m_storageType);
+    const auto thawedCostWidth = static_cast<IGraphStorage::CostWidth>(header.m_costWidth);
+    const bool thawableType = thawedType == ADJACENCY_LIST || thawedType == ADJACENCY_MATRIX ||
+                              thawedType == BIT_MATRIX || thawedType == COMPLETE_GRAPH;
+    if (!thawableType || thawedCostWidth > IGraphStorage::CostWidth::INT32 ||
+        header.m_nodeCount > NODE_LIMIT || header.m_sceneWidth <= 0 || header.m_sceneHeight <= 0) {
+        throw std::runtime_error{"The graph file header is corrupted!"};
+    }
+
+    const auto section = [&]<typename T>(uint64_t offset, uint64_t count) {
+        if (offset % alignof(T) != 0 || offset > fileSize ||
+            count > (fileSize - offset) / sizeof(T)) {
+            throw std::runtime_error{"The graph file is truncated!"};
+        }
+
+        return std::span{reinterpret_cast<const T*>(data + offset), count};
+    };
+
+    const auto nodeCount = header.m_nodeCount, edgeCount = header.m_edgeCount;
+    const auto positions =
+        section.operator()<BinaryGraphPosition_t>(header.m_positionsOffset, nodeCount);
+    const auto offsets = section.operator()<size_t>(header.m_offsetsOffset, nodeCount + 1);
+    const auto targets = section.operator()<NodeIndex_t>(header.m_targetsOffset, edgeCount);
+    const auto costs = section.operator()<CostType_t>(header.m_costsOffset, edgeCount);
+
+    auto storage = std::make_unique<CompressedSparseRow>(offsets, targets, costs, file);
+
+    reset();
+    setSceneDimensions(QSize(header.m_sceneWidth, header.m_sceneHeight));
+
+    m_orientedGraph = header.m_flags & BinaryGraphHeader_t::ORIENTED;
+    m_allowLoops = header.m_flags & BinaryGraphHeader_t::ALLOW_LOOPS;
+    m_drawNodes = header.m_flags & BinaryGraphHeader_t::DRAW_NODES;
+    m_drawEdges = header.m_flags & BinaryGraphHeader_t::DRAW_EDGES;
+    m_editingEnabled = header.m_flags & BinaryGraphHeader_t::ALLOW_EDITING;
+
+    m_graphStorage = std::move(storage);
+    m_thawedStorageType = thawedType;
+    m_thawedCostWidth = thawedCostWidth;
+    m_mappedGraphFile = file;
+
+    // Nodes are placed as saved, so the collision checks of addNode are skipped
+    // and the quad tree is bulk built once at the end.
+    m_nodes.reserve(positions.size());
+    for (const auto& [x, y] : positions) {
+        m_nodes.add(QPoint(x, y), m_nodeDefaultColor);
+    }
+
+    recomputeQuadTree();
+    update(m_sceneRect);
+
+    markEdgesDirty();
+    buildEdgeCache();
+}
+
 void GraphManager::setAllowEditing(bool enabled) { m_editingEnabled = enabled; }
 
 bool GraphManager::getAllowEditing() const { return m_editingEnabled; }
@@ -310,12 +677,8 @@ void GraphManager::setDrawQuadTreesEnabled(bool enabled) { m_drawQuadTrees = ena
 bool GraphManager::getDrawQuadTreesEnabled() const { return m_drawQuadTrees; }
 
 void GraphManager::setNodeDefaultColor(QRgb color) {
-    for (auto& node : m_nodes) {
-        if (node.getFillColor() == m_nodeDefaultColor) {
-            node.setFillColor(color);
-            update(node.getBoundingRect());
-        }
-    }
+    m_nodes.replaceFillColor(m_nodeDefaultColor, color);
+    update(m_sceneRect);
 
     m_nodeDefaultColor = color;
 }
@@ -327,65 +690,93 @@ void GraphManager::setNodeOutlineDefaultColor(QRgb color) {
     }
 }
 
-void GraphManager::evaluateStorageStrategy(size_t edgeCount) {
-    auto switchStorageToType = [this](IGraphStorage::Type type) {
-        std::unique_ptr<IGraphStorage> newStorage;
-        switch (type) {
-            case IGraphStorage::Type::ADJACENCY_LIST:
-                newStorage = std::make_unique<AdjacencyList>();
-                break;
-            case IGraphStorage::Type::ADJACENCY_MATRIX:
-                newStorage = std::make_unique<AdjacencyMatrix>();
-                break;
-        }
+void GraphManager::evaluateStorageStrategy(size_t edgeCount, CostType_t minCost,
+                                           CostType_t maxCost) {
+    const bool weighted = minCost != 0 || maxCost != 0;
+
+    const auto listCostWidth =
+        getNarrowestCostWidth(IGraphStorage::Type::ADJACENCY_LIST, minCost, maxCost);
+    const auto listUsage = visitCostWidth(
+        listCostWidth, [&]<typename StoredCost_t>(std::type_identity<StoredCost_t>) {
+            using List_t = AdjacencyList<StoredCost_t>;
+            using Block_t = typename List_t::AdjacencyList_t::Block_t;
+            return sizeof(List_t) + m_nodes.size() * sizeof(Block_t) +
+                   edgeCount * sizeof(typename List_t::Neighbour_t);
+        });
 
-        newStorage->resize(m_nodes.size());
+    const auto matrixCostWidth =
+        getNarrowestCostWidth(IGraphStorage::Type::ADJACENCY_MATRIX, minCost, maxCost);
+    const auto matrixUsage = visitCostWidth(
+        matrixCostWidth, [&]<typename StoredCost_t>(std::type_identity<StoredCost_t>) {
+            return sizeof(AdjacencyMatrix<StoredCost_t>) +
+                   m_nodes.size() * m_nodes.size() * sizeof(StoredCost_t);
+        });
+    const auto bitMatrixWordsPerRow = (m_nodes.size() + 63) / 64;
+    const auto bitMatrixUsage =
+        sizeof(BitMatrix) + m_nodes.size() * bitMatrixWordsPerRow * sizeof(BitMatrix::Word_t);
+
+    auto bestType = IGraphStorage::Type::ADJACENCY_LIST;
+    auto bestCostWidth = listCostWidth;
+    auto bestUsage = listUsage;
+    if (matrixUsage < bestUsage) {
+        bestType = IGraphStorage::Type::ADJACENCY_MATRIX;
+        bestCostWidth = matrixCostWidth;
+        bestUsage = matrixUsage;
+    }
 
-        for (const auto& nodeData : m_nodes) {
-            const NodeIndex_t i = nodeData.getIndex();
-            const auto loop = m_graphStorage->getEdge(i, i);
-            if (loop) {
-                newStorage->addEdge(i, i, loop.value());
-            }
+    if (!weighted && bitMatrixUsage < bestUsage) {
+        bestType = IGraphStorage::Type::BIT_MATRIX;
+        bestUsage = bitMatrixUsage;
+    }
 
-            m_graphStorage->forEachOutgoingEdgeWithOpposites(
-                i, [&](NodeIndex_t j, CostType_t cost) { newStorage->addEdge(i, j, cost); });
+    const auto currentUsage = [&]() -> std::optional<size_t> {
+        switch (m_graphStorage->type()) {
+            case IGraphStorage::Type::ADJACENCY_LIST:
+                return listUsage;
+            case IGraphStorage::Type::ADJACENCY_MATRIX:
+                return matrixUsage;
+            case IGraphStorage::Type::BIT_MATRIX:
+                return weighted ? std::numeric_limits<size_t>::max() : bitMatrixUsage;
+            default:
+                return std::nullopt;
         }
+    }();
 
-        m_graphStorage = std::move(newStorage);
-    };
-
-    const auto listUsage = sizeof(AdjacencyList) +
-                           m_nodes.size() * sizeof(AdjacencyList::Neighbours_t) +
-                           edgeCount * sizeof(AdjacencyList::Neighbour_t);
-    const auto matrixUsage =
-        sizeof(AdjacencyMatrix) + m_nodes.size() * m_nodes.size() * sizeof(CostType_t);
-
-    const bool switchToMatrix =
-        listUsage > matrixUsage && m_graphStorage->type() == IGraphStorage::Type::ADJACENCY_LIST;
-    const bool switchToList =
-        matrixUsage > listUsage && m_graphStorage->type() == IGraphStorage::Type::ADJACENCY_MATRIX;
-
-    if (!switchToMatrix && !switchToList) {
+    if (!currentUsage || bestUsage >= currentUsage.value()) {
         return;
     }
 
+    const auto costBits = visitCostWidth(bestCostWidth, []<typename StoredCost_t>(
+                                                            std::type_identity<StoredCost_t>) {
+        return sizeof(StoredCost_t) * 8;
+    });
+
+    const auto bestName = [&]() {
+        switch (bestType) {
+            case IGraphStorage::Type::ADJACENCY_MATRIX:
+                return QString("adjacency matrix (%1-bit costs)").arg(costBits);
+            case IGraphStorage::Type::BIT_MATRIX:
+                return QString("bit matrix");
+            default:
+                return QString("adjacency list (%1-bit costs)").arg(costBits);
+        }
+    }();
+
     QMessageBox::information(nullptr, "Memory Usage",
-                             QString("Program has detected that by using an adjacency \n%1 memory "
-                                     "usage will be better.\n\nPredicted "
+                             QString("Program has detected that memory usage will be better "
+                                     "\nwith storage: %1.\n\nPredicted "
                                      "usage with list: %2 bytes.\nPredicted usage with "
-                                     "matrix: %3 bytes.\nEdge count: %4")
-                                 .arg(switchToMatrix ? "matrix" : "list")
+                                     "matrix: %3 bytes.\nPredicted usage with bit matrix: "
+                                     "%4\nEdge count: %5")
+                                 .arg(bestName)
                                  .arg(listUsage)
                                  .arg(matrixUsage)
+                                 .arg(weighted ? QString("unavailable, edges have costs.")
+                                               : QString("%1 bytes.").arg(bitMatrixUsage))
                                  .arg(edgeCount),
                              QMessageBox::Ok);
 
-    if (switchToMatrix) {
-        switchStorageToType(IGraphStorage::Type::ADJACENCY_MATRIX);
-    } else if (switchToList) {
-        switchStorageToType(IGraphStorage::Type::ADJACENCY_LIST);
-    }
+    convertGraphStorage(bestType, bestCostWidth);
 }
 
 bool GraphManager::runningAlgorithm() const { return !m_runningAlgorithms.empty(); }
@@ -460,7 +851,8 @@ void GraphManager::addAlgorithmEdge(NodeIndex_t start, NodeIndex_t end, size_t p
         addArrowToPath(m_algorithmPaths[priority].m_arrowPath, lineEnd, directionNormalized);
     }
 
-    update(m_sceneRect);
+    constexpr auto r = NodeData::k_radius;
+    invalidate(QRect(srcCenter, targetCenter).normalized().adjusted(-r, -r, r, r));
 }
 
 void GraphManager::setAlgorithmPathColor(size_t priority, QRgb color) {
@@ -539,7 +931,7 @@ void GraphManager::paint(QPainter* painter, const QStyleOptionGraphicsItem* opti
     drawAlgorithmEdges(painter);
     drawEdgePreview(painter);
     drawNodes(painter);
-    drawQuadTree(painter, &m_quadTree);
+    drawQuadTree(painter);
 }
 
 void GraphManager::mousePressEvent(QGraphicsSceneMouseEvent* event) {
@@ -590,34 +982,23 @@ void GraphManager::mouseMoveEvent(QGraphicsSceneMouseEvent* event) {
     if (event->buttons() & Qt::LeftButton && m_selectedNodes.size() == 1 &&
         !(event->modifiers() & Qt::ControlModifier) && !runningAlgorithm()) {
         const auto selectedIndex = *m_selectedNodes.begin();
-        auto& node = getNode(selectedIndex);
+        auto node = getNode(selectedIndex);
         const auto desiredPos = event->pos().toPoint() + m_dragOffset;
 
         if (isGoodPosition(desiredPos, selectedIndex)) {
+            if (!m_draggingNode) {
+                m_draggedEdgesRect = getIncidentEdgesRect(selectedIndex);
+            }
+
             m_draggingNode = true;
             setCursor(Qt::ClosedHandCursor);
 
-            std::vector<QuadTree*> containingTrees;
-            m_quadTree.getContainingTrees(node, containingTrees);
-
             const auto oldRect = node.getBoundingRect();
             node.setPosition(desiredPos);
             const auto newRect = node.getBoundingRect();
             update(oldRect.united(newRect));
 
-            bool removedFromEveryTree = true;
-            for (const auto tree : containingTrees) {
-                if (tree->needsReinserting(node)) {
-                    tree->remove(node);
-                } else {
-                    removedFromEveryTree = false;
-                    tree->update(node);
-                }
-            }
-
-            if (removedFromEveryTree) {
-                m_quadTree.insert(node);
-            }
+            m_quadTree.update(node);
         }
     } else if (event->buttons() & Qt::MiddleButton && getAllowEditing() && !runningAlgorithm()) {
         m_edgePreviewEndPoint = event->pos().toPoint();
@@ -634,7 +1015,10 @@ void GraphManager::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
     if (event->button() == Qt::LeftButton) {
         setFlag(ItemIsSelectable, false);
         if (m_draggingNode) {
-            m_edgesDirty = true;
+            // Only the edges of the dragged node moved, from where it started to where it is.
+            const auto selectedIndex = *m_selectedNodes.begin();
+            markEdgesDirty(m_draggedEdgesRect.united(getIncidentEdgesRect(selectedIndex)),
+                           getIncidentEdges(selectedIndex));
             m_draggingNode = false;
             setCursor(Qt::ArrowCursor);
         } else if (m_pressedEmptySpace && !(event->modifiers() & Qt::ControlModifier)) {
@@ -656,14 +1040,138 @@ void GraphManager::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
     QGraphicsObject::mouseReleaseEvent(event);
 }
 
+std::unique_ptr<IGraphStorage> GraphManager::createGraphStorage(
+    IGraphStorage::Type type, IGraphStorage::CostWidth costWidth) {
+    switch (type) {
+        case IGraphStorage::Type::ADJACENCY_LIST:
+            return visitCostWidth(costWidth, []<typename StoredCost_t>(
+                                                 std::type_identity<StoredCost_t>)
+                                                 -> std::unique_ptr<IGraphStorage> {
+                return std::make_unique<AdjacencyList<StoredCost_t>>();
+            });
+        case IGraphStorage::Type::ADJACENCY_MATRIX:
+            return visitCostWidth(costWidth, []<typename StoredCost_t>(
+                                                 std::type_identity<StoredCost_t>)
+                                                 -> std::unique_ptr<IGraphStorage> {
+                return std::make_unique<AdjacencyMatrix<StoredCost_t>>();
+            });
+        case IGraphStorage::Type::COMPRESSED_SPARSE_ROW:
+            return std::make_unique<CompressedSparseRow>();
+        case IGraphStorage::Type::BIT_MATRIX:
+            return std::make_unique<BitMatrix>();
+        case IGraphStorage::Type::COMPLETE_GRAPH:
+            return std::make_unique<ImplicitCompleteGraph>();
+        case IGraphStorage::Type::COMPRESSED_VARINT_ROW:
+            return std::make_unique<CompressedVarintRow>();
+        default:
+            throw std::runtime_error("Unknown graph storage type.");
+    }
+}
+
+void GraphManager::convertGraphStorage(IGraphStorage::Type type,
+                                       IGraphStorage::CostWidth costWidth) {
+    if (type == IGraphStorage::Type::COMPRESSED_SPARSE_ROW) {
+        m_graphStorage = std::make_unique<CompressedSparseRow>(*m_graphStorage, m_nodes.size());
+        return;
+    }
+
+    if (type == IGraphStorage::Type::COMPRESSED_VARINT_ROW) {
+        m_graphStorage = std::make_unique<CompressedVarintRow>(*m_graphStorage, m_nodes.size());
+        return;
+    }
+
+    // Replaying every edge would store all of them as overrides of an empty clique.
+    if (type == IGraphStorage::Type::COMPLETE_GRAPH) {
+        m_graphStorage =
+            std::make_unique<ImplicitCompleteGraph>(*m_graphStorage, m_nodes.size(), m_allowLoops);
+        return;
+    }
+
+    auto newStorage = createGraphStorage(type, costWidth);
+    newStorage->resize(m_nodes.size());
+
+    // Every storage reports loops among the neighbours, so one pass copies all edges.
+    std::vector<IGraphStorage::Edge_t> edges;
+    for (NodeIndex_t i = 0; i < m_nodes.size(); ++i) {
+        forEachNeighbour(*m_graphStorage, i,
+                         [&](NodeIndex_t j, CostType_t cost) { edges.push_back({i, j, cost}); });
+    }
+
+    newStorage->addEdges(edges);
+    m_graphStorage = std::move(newStorage);
+}
+
+std::pair<CostType_t, CostType_t> GraphManager::getCostRange(IGraphStorage::Type type,
+                                                             IGraphStorage::CostWidth costWidth) {
+    return visitCostWidth(costWidth, [type]<typename StoredCost_t>(
+                                         std::type_identity<StoredCost_t>) {
+        switch (type) {
+            case IGraphStorage::Type::ADJACENCY_LIST:
+                return std::pair{AdjacencyList<StoredCost_t>::MIN_COST,
+                                 AdjacencyList<StoredCost_t>::MAX_COST};
+            case IGraphStorage::Type::ADJACENCY_MATRIX:
+                return std::pair{AdjacencyMatrix<StoredCost_t>::MIN_COST,
+                                 AdjacencyMatrix<StoredCost_t>::MAX_COST};
+            default:
+                return std::pair{std::numeric_limits<CostType_t>::min(),
+                                 std::numeric_limits<CostType_t>::max()};
+        }
+    });
+}
+
+IGraphStorage::CostWidth GraphManager::getNarrowestCostWidth(IGraphStorage::Type type,
+                                                             CostType_t minCost,
+                                                             CostType_t maxCost) {
+    for (const auto costWidth : {IGraphStorage::CostWidth::INT8, IGraphStorage::CostWidth::INT16}) {
+        const auto [lowest, highest] = getCostRange(type, costWidth);
+        if (lowest <= minCost && maxCost <= highest) {
+            return costWidth;
+        }
+    }
+
+    return IGraphStorage::CostWidth::INT32;
+}
+
+void GraphManager::widenCostsToFit(CostType_t minCost, CostType_t maxCost) {
+    const auto type = m_graphStorage->type();
+    if (type == IGraphStorage::Type::BIT_MATRIX) {
+        if (minCost != 0 || maxCost != 0) {
+            convertGraphStorage(
+                IGraphStorage::Type::ADJACENCY_MATRIX,
+                getNarrowestCostWidth(IGraphStorage::Type::ADJACENCY_MATRIX, minCost, maxCost));
+        }
+        return;
+    }
+
+    const auto costWidth = getNarrowestCostWidth(type, minCost, maxCost);
+    if (costWidth > m_graphStorage->costWidth()) {
+        convertGraphStorage(type, costWidth);
+    }
+}
+
+int32_t GraphManager::clampEdgeCost(int32_t cost) const {
+    const auto [minCost, maxCost] =
+        getCostRange(m_graphStorage->type(), m_graphStorage->costWidth());
+    return std::clamp(cost, minCost, maxCost);
+}
+
 void GraphManager::drawEdgeCache(QPainter* painter) const {
     if (!m_drawEdges) {
         return;
     }
 
-    painter->setPen(
-        QPen{QColor::fromRgb(runningAlgorithm() ? qRgb(200, 200, 200) : m_nodeOutlineDefaultColor),
-             2. + m_additionalEdgeThickness});
+    const QPen pen{
+        QColor::fromRgb(runningAlgorithm() ? qRgb(200, 200, 200) : m_nodeOutlineDefaultColor),
+        2. + m_additionalEdgeThickness};
+
+    // The tiles also stand in for the edges while the cache catches up with a zoom in.
+    if (shouldUseEdgeTiles() || m_edgeCache.m_builtForEdgeTiles) {
+        m_edgeTiles.draw(painter, m_sceneRect, m_currentLod, pen,
+                         [this](const QRect& area) { return getEdgeTilePathBuilder(area); });
+        return;
+    }
+
+    painter->setPen(pen);
     painter->setBrush(Qt::NoBrush);
     painter->drawPath(m_edgeCache.m_edgePath);
 }
@@ -724,7 +1232,7 @@ void GraphManager::drawNodes(QPainter* painter) const {
     const auto outlineColor = QColor::fromRgb(m_nodeOutlineDefaultColor);
     if (!m_drawNodes) {
         for (const auto nodeIndex : m_selectedNodes) {
-            const auto& node = m_nodes[nodeIndex];
+            const auto node = m_nodes[nodeIndex];
             const auto& rect = node.getBoundingRect();
 
             painter->setPen(QPen{node.isSelected() ? Qt::green : outlineColor, 1.5});
@@ -735,32 +1243,32 @@ void GraphManager::drawNodes(QPainter* painter) const {
             }
         }
 
+        m_nodes.retainLabels(m_sceneRect);
         return;
     }
 
-    std::vector<bool> visitMask(m_nodes.size(), false);
     std::vector<NodeIndex_t> visibleNodes;
-    m_quadTree.getNodesInArea(m_sceneRect, visitMask, visibleNodes);
+    m_quadTree.getNodesInArea(m_sceneRect, visibleNodes);
 
     for (const auto nodeIndex : visibleNodes) {
-        const auto& node = m_nodes[nodeIndex];
+        const auto node = m_nodes[nodeIndex];
         const auto& rect = node.getBoundingRect();
 
         if (m_currentLod >= 1 && m_drawEdges) {
             painter->setPen(QColor::fromRgb(m_nodeOutlineDefaultColor));
 
-            m_graphStorage->forEachOutgoingEdge(
-                nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
+            forEachUniqueNeighbour(
+                *m_graphStorage, nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
                     const auto oppositeEdge =
                         m_orientedGraph ? m_graphStorage->getEdge(neighbourIndex, nodeIndex)
                                         : std::nullopt;
                     const auto oppositeCost = oppositeEdge.has_value() ? oppositeEdge.value() : 0;
 
-                    if (cost == 0 && oppositeCost == 0) {
+                    if ((cost == 0 && oppositeCost == 0) || isNodeRemoved(neighbourIndex)) {
                         return;
                     }
 
-                    const auto& neighbour = m_nodes[neighbourIndex];
+                    const auto neighbour = m_nodes[neighbourIndex];
                     const auto mid = (node.getPosition() + neighbour.getPosition()) * 0.5f;
                     const auto direction = neighbour.getPosition() - node.getPosition();
 
@@ -825,34 +1333,24 @@ void GraphManager::drawNodes(QPainter* painter) const {
         painter->setBrush(Qt::NoBrush);
         painter->drawPath(m_edgeCache.m_loopEdgePath);
     }
+
+    m_nodes.retainLabels(m_sceneRect);
 }
 
-void GraphManager::drawQuadTree(QPainter* painter, QuadTree* quadTree) const {
+void GraphManager::drawQuadTree(QPainter* painter) const {
     if (!m_drawQuadTrees || m_currentLod < 1.5) {
         return;
     }
 
-    if (!quadTree || !isVisibleInScene(quadTree->getBoundary())) {
-        return;
-    }
+    std::vector<QRect> cells;
+    m_quadTree.getCellsInArea(m_sceneRect, cells);
 
     painter->setPen(Qt::gray);
     painter->setBrush(Qt::NoBrush);
 
-    painter->drawRect(quadTree->getBoundary());
-    if (!quadTree->isSubdivided()) {
-        return;
+    for (const auto& cell : cells) {
+        painter->drawRect(cell);
     }
-
-    const auto northWest = quadTree->getNorthWest().get();
-    const auto northEast = quadTree->getNorthEast().get();
-    const auto southWest = quadTree->getSouthWest().get();
-    const auto southEast = quadTree->getSouthEast().get();
-
-    drawQuadTree(painter, northWest);
-    drawQuadTree(painter, northEast);
-    drawQuadTree(painter, southWest);
-    drawQuadTree(painter, southEast);
 }
 
 void GraphManager::updateAlgorithmInfoTextPos() {
@@ -939,15 +1437,148 @@ void GraphManager::addEdgeToPath(QPainterPath& edgePath, NodeIndex_t nodeIndex,
     edgePath.lineTo(targetCenter);
 }
 
-bool GraphManager::isVisibleInScene(const QRect& rect) const {
-    return m_sceneRect.intersects(rect);
+EdgeTileCache::PathBuilder_t GraphManager::getEdgeTilePathBuilder(const QRect& area) const {
+    // Workers only see this snapshot, never the graph the GUI thread keeps editing.
+    // Edits patch it, and only replacing the whole graph makes the next tile take a new one.
+    if (!m_edgeSegments) {
+        m_edgeSegments = std::make_shared<const EdgeSegmentIndex>(
+            *m_graphStorage, m_nodes.getPositions(), m_removedNodes);
+    }
+
+    // Edges shorter than a pixel of the tile don't show, and loops are drawn with the nodes.
+    const auto minLength = std::max(area.width() / EdgeTileCache::k_tileSize, 1);
+
+    // Edges passing just outside the tile still have their stroke reach into it.
+    const auto margin = area.width() / 16;
+
+    return [edgeSegments = m_edgeSegments, area = area.adjusted(-margin, -margin, margin, margin),
+            minLength]() {
+        std::vector<QLineF> segments;
+        edgeSegments->getSegmentsInArea(area, minLength, segments);
+
+        QPainterPath edgePath;
+        for (const auto& segment : segments) {
+            edgePath.moveTo(segment.p1());
+            edgePath.lineTo(segment.p2());
+        }
+
+        return edgePath;
+    };
 }
 
-void GraphManager::recomputeQuadTree() {
-    m_quadTree.clear();
-    for (const auto& node : m_nodes) {
-        m_quadTree.insert(node);
+QRect GraphManager::getIncidentEdgesRect(NodeIndex_t nodeIndex) const {
+    auto rect = m_nodes[nodeIndex].getBoundingRect();
+    const auto uniteNeighbour = [&](NodeIndex_t neighbourIndex, CostType_t) {
+        rect = rect.united(m_nodes[neighbourIndex].getBoundingRect());
+    };
+
+    forEachNeighbour(*m_graphStorage, nodeIndex, uniteNeighbour);
+    if (m_orientedGraph) {
+        forEachIncomingNeighbour(*m_graphStorage, nodeIndex, uniteNeighbour);
+    }
+
+    return rect;
+}
+
+std::vector<EdgeSegmentIndex::NodePair_t> GraphManager::getIncidentEdges(
+    NodeIndex_t nodeIndex) const {
+    std::vector<EdgeSegmentIndex::NodePair_t> edges;
+    const auto addNeighbour = [&](NodeIndex_t neighbourIndex, CostType_t) {
+        edges.emplace_back(nodeIndex, neighbourIndex);
+    };
+
+    forEachNeighbour(*m_graphStorage, nodeIndex, addNeighbour);
+    if (m_orientedGraph) {
+        forEachIncomingNeighbour(*m_graphStorage, nodeIndex, addNeighbour);
+    }
+
+    return edges;
+}
+
+QRect GraphManager::getEdgesRect(std::span<const IGraphStorage::Edge_t> edges) const {
+    QRect rect;
+    for (const auto& edge : edges) {
+        rect = rect.united(m_nodes[edge.m_start].getBoundingRect())
+                   .united(m_nodes[edge.m_end].getBoundingRect());
     }
+
+    return rect;
+}
+
+bool GraphManager::shouldUseEdgeTiles() const { return m_currentLod < k_edgeTilesMaxLod; }
+
+void GraphManager::dropEdgeSegments() {
+    m_edgeSegments.reset();
+
+    // A running compaction is thrown away once it finishes.
+    m_edgeSegmentsPatchedPairs.clear();
+    m_compactingEdgeSegments = false;
+    ++m_edgeSegmentsCompactionId;
+}
+
+void GraphManager::patchEdgeSegments(
+    std::span<const EdgeSegmentIndex::NodePair_t> changedEdges) {
+    // Without a snapshot, the next tile requested takes one with the edits in it.
+    if (!m_edgeSegments || changedEdges.empty()) {
+        return;
+    }
+
+    m_edgeSegments = getPatchedEdgeSegments(*m_edgeSegments, changedEdges);
+
+    if (m_compactingEdgeSegments) {
+        m_edgeSegmentsPatchedPairs.insert(m_edgeSegmentsPatchedPairs.end(), changedEdges.begin(),
+                                          changedEdges.end());
+        return;
+    }
+
+    if (!m_edgeSegments->needsCompaction()) {
+        return;
+    }
+
+    m_compactingEdgeSegments = true;
+    const auto compactionId = ++m_edgeSegmentsCompactionId;
+
+    QtConcurrent::run([edgeSegments = m_edgeSegments]() { return edgeSegments->compacted(); })
+        .then(this, [this, compactionId](std::shared_ptr<const EdgeSegmentIndex> compacted) {
+            // Dropped while compacting, the next tile takes a new snapshot anyway.
+            if (compactionId != m_edgeSegmentsCompactionId) {
+                return;
+            }
+
+            m_edgeSegments = getPatchedEdgeSegments(*compacted, m_edgeSegmentsPatchedPairs);
+            m_edgeSegmentsPatchedPairs.clear();
+            m_compactingEdgeSegments = false;
+        });
+}
+
+std::shared_ptr<const EdgeSegmentIndex> GraphManager::getPatchedEdgeSegments(
+    const EdgeSegmentIndex& edgeSegments,
+    std::span<const EdgeSegmentIndex::NodePair_t> changedEdges) const {
+    // Either direction of an edge draws the same segment.
+    std::vector<EdgeSegmentIndex::NodePair_t> pairs;
+    pairs.reserve(changedEdges.size());
+    for (const auto [start, end] : changedEdges) {
+        pairs.emplace_back(std::min(start, end), std::max(start, end));
+    }
+    std::ranges::sort(pairs);
+    pairs.erase(std::ranges::unique(pairs).begin(), pairs.end());
+
+    std::vector<EdgeSegmentIndex::Segment_t> segments;
+    for (const auto& [start, end] : pairs) {
+        const auto drawn = start != end && !isNodeRemoved(start) && !isNodeRemoved(end) &&
+                           (hasNeighbour(start, end) || hasNeighbour(end, start));
+        if (drawn) {
+            segments.push_back(
+                {{start, end}, QLine(m_nodes[start].getPosition(), m_nodes[end].getPosition())});
+        }
+    }
+
+    return edgeSegments.patched(pairs, segments);
+}
+
+// Removed nodes stay out of the tree, like removeSelectedNodes left them.
+void GraphManager::recomputeQuadTree() {
+    m_quadTree.build(m_nodes.getPositions(), m_removedNodes);
 }
 
 void GraphManager::removeSelectedNodes() {
@@ -955,30 +1586,126 @@ void GraphManager::removeSelectedNodes() {
         return;
     }
 
-    m_graphStorage->recomputeBeforeRemovingNodes(m_nodes.size(), m_selectedNodes);
+    m_removedNodes.resize(m_nodes.size(), false);
 
+    QRect removedEdgesRect;
+    std::vector<EdgeSegmentIndex::NodePair_t> removedEdges;
     for (NodeIndex_t index : m_selectedNodes) {
-        if (index >= m_nodes.size()) {
+        if (index >= m_nodes.size() || m_removedNodes[index]) {
             continue;
         }
 
-        update(m_nodes[index].getBoundingRect());
-        m_nodes.erase(m_nodes.begin() + index);
+        auto node = m_nodes[index];
+        node.deselect();
+        update(node.getBoundingRect());
+
+        removedEdgesRect = removedEdgesRect.united(getIncidentEdgesRect(index));
+        const auto incidentEdges = getIncidentEdges(index);
+        removedEdges.insert(removedEdges.end(), incidentEdges.begin(), incidentEdges.end());
+
+        m_quadTree.remove(node);
+
+        m_removedNodes[index] = true;
+        ++m_removedNodesCount;
     }
 
+    m_selectedNodes.clear();
+
+    // Patched before compacting, which moves the nodes to other indices.
+    markEdgesDirty(removedEdgesRect, removedEdges);
+
+    if (m_removedNodesCount >= m_nodes.size() * k_removedNodesCompactionRatio) {
+        compactRemovedNodes();
+    }
+}
+
+void GraphManager::compactRemovedNodes() {
+    if (m_removedNodesCount == 0) {
+        return;
+    }
+
+    std::set<NodeIndex_t, std::greater<NodeIndex_t>> removedNodes;
+    std::vector<NodeIndex_t> indexRemap(m_nodes.size(), INVALID_NODE);
+    for (NodeIndex_t oldIndex = 0, newIndex = 0; oldIndex < m_nodes.size(); ++oldIndex) {
+        if (isNodeRemoved(oldIndex)) {
+            removedNodes.insert(oldIndex);
+        } else {
+            indexRemap[oldIndex] = newIndex++;
+        }
+    }
+
+    m_graphStorage->recomputeBeforeRemovingNodes(m_nodes.size(), removedNodes);
+
+    // One pass moves the surviving nodes down instead of erasing them one by one.
+    m_nodes.compact(m_removedNodes);
+
+    std::set<NodeIndex_t, std::greater<NodeIndex_t>> selectedNodes;
+    for (const auto index : m_selectedNodes) {
+        selectedNodes.insert(indexRemap[index]);
+    }
+    m_selectedNodes = std::move(selectedNodes);
+
+    m_removedNodes.clear();
+    m_removedNodesCount = 0;
+
+    recomputeQuadTree();
+    update(m_sceneRect);
+
+    // Every edge left is drawn where it was, so the tiles stay valid, but the
+    // snapshot knows the nodes by their old indices.
+    dropEdgeSegments();
+}
+
+void GraphManager::permuteNodes(std::span<const NodeIndex_t> order) {
+    std::vector<NodeIndex_t> indexRemap(m_nodes.size(), INVALID_NODE);
+    for (NodeIndex_t newIndex = 0; newIndex < order.size(); ++newIndex) {
+        indexRemap[order[newIndex]] = newIndex;
+    }
+
+    std::vector<IGraphStorage::Edge_t> edges;
     for (NodeIndex_t i = 0; i < m_nodes.size(); ++i) {
-        m_nodes[i].setIndex(i);
-        update(m_nodes[i].getBoundingRect());
+        forEachNeighbour(*m_graphStorage, i, [&](NodeIndex_t j, CostType_t cost) {
+            edges.push_back({indexRemap[i], indexRemap[j], cost});
+        });
+    }
+
+    // A frozen graph is rebuilt in its thawed storage and frozen again right after.
+    const bool frozen = isGraphStorageFrozen();
+    const auto frozenType = m_graphStorage->type();
+
+    auto newStorage = createGraphStorage(getThawedGraphStorageType(),
+                                         frozen ? m_thawedCostWidth : m_graphStorage->costWidth());
+    newStorage->resize(m_nodes.size());
+    newStorage->addEdges(edges);
+    m_graphStorage = std::move(newStorage);
+
+    if (frozen) {
+        convertGraphStorage(frozenType, m_thawedCostWidth);
     }
 
+    m_nodes.permute(order);
+
+    std::set<NodeIndex_t, std::greater<NodeIndex_t>> selectedNodes;
+    for (const auto index : m_selectedNodes) {
+        selectedNodes.insert(indexRemap[index]);
+    }
+    m_selectedNodes = std::move(selectedNodes);
+
     recomputeQuadTree();
+    update(m_sceneRect);
 
-    m_selectedNodes.clear();
+    // Nodes kept their positions, so the tiles stay valid, but not the indices
+    // the snapshot knows them by.
+    dropEdgeSegments();
+}
+
+bool GraphManager::isNodeRemoved(NodeIndex_t index) const {
+    return index < m_removedNodes.size() && m_removedNodes[index];
 }
 
 void GraphManager::deselectNodes() {
     for (const auto nodeIndex : m_selectedNodes) {
-        auto& node = m_nodes[nodeIndex];
+        auto node = m_nodes[nodeIndex];
 
         node.deselect();
         update(node.getBoundingRect());
@@ -998,6 +1725,8 @@ void GraphManager::handleInteractiveEdgeAction(const QPoint& mousePos) {
         return;
     }
 
+    thawGraphStorage();
+
     if (hasNeighbour(m_edgePreviewStartNode, targetNode)) {
         m_graphStorage->removeEdge(m_edgePreviewStartNode, targetNode);
         if (!m_orientedGraph) {
@@ -1010,7 +1739,11 @@ void GraphManager::handleInteractiveEdgeAction(const QPoint& mousePos) {
         }
     }
 
-    m_edgesDirty = true;
+    const std::array<EdgeSegmentIndex::NodePair_t, 1> changedEdges{
+        {{m_edgePreviewStartNode, targetNode}}};
+    markEdgesDirty(m_nodes[m_edgePreviewStartNode].getBoundingRect().united(
+                       m_nodes[targetNode].getBoundingRect()),
+                   changedEdges);
     buildEdgeCache();
 }
 
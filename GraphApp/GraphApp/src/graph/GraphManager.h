@@ -2,23 +2,36 @@
 
 #include "storage/IGraphStorage.h"
 
+#include "EdgeSegmentIndex.h"
+#include "EdgeTileCache.h"
+#include "NodeStore.h"
 #include "QuadTree.h"
 
 class IAlgorithm;
 
 constexpr size_t NODE_LIMIT = 100'000'000;
 
+// Graphs with at least this many nodes freeze into the varint compressed storage.
+constexpr size_t COMPRESSED_STORAGE_NODE_THRESHOLD = 1'000'000;
+
 class GraphManager : public QGraphicsObject {
     Q_OBJECT
 
    public:
     friend class Graph;
 
+    enum class NodeOrder { HILBERT_CURVE, REVERSE_CUTHILL_MCKEE, BREADTH_FIRST };
+
     GraphManager();
 
     void setGraphStorageType(IGraphStorage::Type type);
     const std::unique_ptr<IGraphStorage>& getGraphStorage() const;
 
+    void freezeGraphStorage();
+    void thawGraphStorage();
+    bool isGraphStorageFrozen() const;
+    IGraphStorage::Type getThawedGraphStorageType() const;
+
     void setSceneDimensions(QSize size);
     bool isGoodPosition(const QPoint& pos, NodeIndex_t nodeToIgnore = -1) const;
     void setCollisionsCheckEnabled(bool enabled);
@@ -28,15 +41,25 @@ class GraphManager : public QGraphicsObject {
     size_t getSelectedNodesCount() const;
     void reserveNodes(size_t count);
 
-    NodeData& getNode(NodeIndex_t index);
+    NodeData getNode(NodeIndex_t index);
     std::optional<NodeIndex_t> getNode(const QPoint& pos, float minDistance = NodeData::k_radius);
     std::optional<NodeIndex_t> getSelectedNode() const;
     std::optional<std::pair<NodeIndex_t, NodeIndex_t>> getTwoSelectedNodes() const;
 
     bool hasNeighbour(NodeIndex_t index, NodeIndex_t neighbour) const;
 
+    void resetNodeStates(NodeData::State state, QRgb fillColor);
+
+    // Queues a repaint of rect; queued rects are merged and flushed once per frame.
+    void invalidate(const QRect& rect);
+
     bool addNode(const QPoint& pos);
+    // Adds the same nodes as calling addNode for each position, whatever the batch
+    // size: with collision checks on, positions too close to an earlier node, of
+    // the batch or not, are skipped. Large batches rebuild the quad tree once.
+    void addNodes(std::span<const QPoint> positions);
     void addEdge(NodeIndex_t start, NodeIndex_t end, int32_t cost);
+    void addEdges(std::span<IGraphStorage::Edge_t> edges);
     void randomlyAddEdges(size_t edgeCount);
 
     size_t getMaxEdgesCount() const;
@@ -44,12 +67,23 @@ class GraphManager : public QGraphicsObject {
     void resizeAdjacencyMatrix(size_t nodeCount);
     void resetAdjacencyMatrix();
 
+    // Any edge may have changed, e.g. after the whole graph got replaced.
     void markEdgesDirty();
+    // Only the edges between the changedEdges pairs changed, all of them inside
+    // rect, e.g. those of a moved node.
+    void markEdgesDirty(const QRect& rect,
+                        std::span<const EdgeSegmentIndex::NodePair_t> changedEdges);
     void buildEdgeCache();
 
     void completeGraph();
     void fillGraph();
 
+    void compactRemovedNodes();
+    void reorderNodes(NodeOrder order);
+
+    void saveBinaryGraph(const QString& filePath);
+    void loadBinaryGraph(const QString& filePath);
+
     void setAllowEditing(bool enabled);
     bool getAllowEditing() const;
 
@@ -71,7 +105,7 @@ class GraphManager : public QGraphicsObject {
     void setNodeDefaultColor(QRgb color);
     void setNodeOutlineDefaultColor(QRgb color);
 
-    void evaluateStorageStrategy(size_t edgeCount);
+    void evaluateStorageStrategy(size_t edgeCount, CostType_t minCost, CostType_t maxCost);
 
     bool runningAlgorithm() const;
     void registerAlgorithm(IAlgorithm* algorithm);
@@ -101,22 +135,44 @@ class GraphManager : public QGraphicsObject {
     void mouseReleaseEvent(QGraphicsSceneMouseEvent* event) override;
 
    private:
+    static std::unique_ptr<IGraphStorage> createGraphStorage(IGraphStorage::Type type,
+                                                             IGraphStorage::CostWidth costWidth);
+    void convertGraphStorage(IGraphStorage::Type type, IGraphStorage::CostWidth costWidth);
+
+    static std::pair<CostType_t, CostType_t> getCostRange(IGraphStorage::Type type,
+                                                          IGraphStorage::CostWidth costWidth);
+    static IGraphStorage::CostWidth getNarrowestCostWidth(IGraphStorage::Type type,
+                                                          CostType_t minCost, CostType_t maxCost);
+    void widenCostsToFit(CostType_t minCost, CostType_t maxCost);
+    int32_t clampEdgeCost(int32_t cost) const;
+
     void drawEdgeCache(QPainter* painter) const;
     void drawAlgorithmEdges(QPainter* painter) const;
     void drawEdgePreview(QPainter* painter) const;
     void drawNodes(QPainter* painter) const;
-    void drawQuadTree(QPainter* painter, QuadTree* quadTree) const;
+    void drawQuadTree(QPainter* painter) const;
     void updateAlgorithmInfoTextPos();
 
     void addArrowToPath(QPainterPath& path, QPoint tip, const QPointF& dir) const;
     void addEdgeToPath(QPainterPath& edgePath, NodeIndex_t nodeIndex, NodeIndex_t neighbourIndex,
                        CostType_t cost) const;
-
-    bool isVisibleInScene(const QRect& rect) const;
+    EdgeTileCache::PathBuilder_t getEdgeTilePathBuilder(const QRect& area) const;
+    QRect getIncidentEdgesRect(NodeIndex_t nodeIndex) const;
+    std::vector<EdgeSegmentIndex::NodePair_t> getIncidentEdges(NodeIndex_t nodeIndex) const;
+    QRect getEdgesRect(std::span<const IGraphStorage::Edge_t> edges) const;
+    bool shouldUseEdgeTiles() const;
+
+    void dropEdgeSegments();
+    void patchEdgeSegments(std::span<const EdgeSegmentIndex::NodePair_t> changedEdges);
+    std::shared_ptr<const EdgeSegmentIndex> getPatchedEdgeSegments(
+        const EdgeSegmentIndex& edgeSegments,
+        std::span<const EdgeSegmentIndex::NodePair_t> changedEdges) const;
 
     void recomputeQuadTree();
 
     void removeSelectedNodes();
+    void permuteNodes(std::span<const NodeIndex_t> order);
+    bool isNodeRemoved(NodeIndex_t index) const;
     void deselectNodes();
 
     void handleInteractiveEdgeAction(const QPoint& mousePos);
@@ -128,11 +184,14 @@ class GraphManager : public QGraphicsObject {
             m_edgePath.clear();
             m_loopEdgePath.clear();
             m_builtWithLod = 0;
+            m_builtForEdgeTiles = false;
         }
 
         QPainterPath m_edgePath;
         QPainterPath m_loopEdgePath;
         qreal m_builtWithLod{};
+        // Only loops are cached then, the other edges are drawn from m_edgeTiles.
+        bool m_builtForEdgeTiles{false};
     };
 
     struct AlgorithmPath {
@@ -144,10 +203,13 @@ class GraphManager : public QGraphicsObject {
     QRect m_boundingRect{};
     QRect m_sceneRect{};
 
-    std::vector<NodeData> m_nodes;
+    NodeStore m_nodes;
     QuadTree m_quadTree;
     EdgeCache m_edgeCache;
     std::unique_ptr<IGraphStorage> m_graphStorage{};
+    IGraphStorage::Type m_thawedStorageType{IGraphStorage::Type::ADJACENCY_LIST};
+    IGraphStorage::CostWidth m_thawedCostWidth{IGraphStorage::CostWidth::INT8};
+    std::weak_ptr<QFile> m_mappedGraphFile{};
 
     std::vector<IAlgorithm*> m_runningAlgorithms;
     std::map<int64_t, AlgorithmPath> m_algorithmPaths;
@@ -157,7 +219,17 @@ class GraphManager : public QGraphicsObject {
 
     std::set<NodeIndex_t, std::greater<NodeIndex_t>> m_selectedNodes{};
 
+    // Removed nodes stay in m_nodes and in the storage until compaction, but are
+    // taken out of the quad tree so they can't be drawn or picked anymore.
+    std::vector<bool> m_removedNodes{};
+    size_t m_removedNodesCount{0};
+    static constexpr auto k_removedNodesCompactionRatio{0.25};
+
+    // Batches at least this large rebuild the quad tree instead of inserting one by one.
+    static constexpr size_t k_bulkInsertThreshold{4096};
+
     QPoint m_dragOffset{}, m_edgePreviewEndPoint{};
+    QRect m_draggedEdgesRect{};
     qreal m_currentLod{1.0};
 
     NodeIndex_t m_edgePreviewStartNode{INVALID_NODE};
@@ -165,6 +237,20 @@ class GraphManager : public QGraphicsObject {
     QFuture<EdgeCache> m_edgeFuture;
     QFutureWatcher<EdgeCache> m_edgeWatcher;
 
+    // Zoomed out further than this, edges are drawn from rasterized tiles, which
+    // are rendered from m_edgeSegments. Both are filled in while drawing, edits
+    // patch the snapshot and a worker folds the patches in once they pile up.
+    mutable EdgeTileCache m_edgeTiles;
+    mutable std::shared_ptr<const EdgeSegmentIndex> m_edgeSegments{};
+    // Pairs patched while the compaction runs, patched again into its result.
+    std::vector<EdgeSegmentIndex::NodePair_t> m_edgeSegmentsPatchedPairs{};
+    uint64_t m_edgeSegmentsCompactionId{0};
+    static constexpr auto k_edgeTilesMaxLod{1.0};
+
+    QRect m_invalidatedRect{};
+    QTimer m_invalidateTimer;
+    static constexpr auto k_invalidateIntervalMs{16};
+
     bool m_collisionsCheckEnabled : 1 {true};
     bool m_draggingNode : 1 {false};
     bool m_pressedEmptySpace : 1 {false};
@@ -176,6 +262,7 @@ class GraphManager : public QGraphicsObject {
     bool m_drawEdges : 1 {true};
     bool m_drawQuadTrees : 1 {false};
     bool m_edgesDirty : 1 {false};
+    bool m_compactingEdgeSegments : 1 {false};
     bool m_addingAlgorithmEdgesAllowed : 1 {true};
 
     QRgb m_nodeDefaultColor{qRgb(255, 255, 255)};
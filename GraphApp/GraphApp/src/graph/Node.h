@@ -3,21 +3,29 @@
 using NodeIndex_t = uint32_t;
 constexpr auto INVALID_NODE = std::numeric_limits<NodeIndex_t>::max();
 
+class NodeStore;
+
+/**
+ * @class NodeData
+ * @brief Handle to one node of a NodeStore.
+ *
+ * Handles are cheap to copy and forward every call to the store's arrays. They
+ * stay valid until the store is cleared, compacted or permuted.
+ */
 class NodeData {
    public:
     enum class State : uint8_t { NONE = 0, UNVISITED, VISITED, ANALYZING, ANALYZED, UNREACHABLE };
 
-    NodeData(size_t index, const QPoint& position);
+    NodeData(NodeStore& store, NodeIndex_t index);
 
+    static QRect getBoundingRect(const QPoint& position);
     QRect getBoundingRect() const;
 
-    void setIndex(NodeIndex_t index);
     NodeIndex_t getIndex() const;
 
     void setFillColor(QRgb c);
     QColor getFillColor() const;
 
-    void setLabel(const QString& label);
     const QString& getLabel() const;
 
     void setPosition(const QPoint& position);
@@ -32,15 +40,39 @@ class NodeData {
     State getState() const;
 
    private:
-    NodeIndex_t m_index{INVALID_NODE};
-    QRgb m_fillColor{};
-
-    QPoint m_position{};
-    QString m_label{};
-
-    uint32_t m_selectOrder = -1;
-    State m_state{State::NONE};
+    NodeStore* m_store;
+    NodeIndex_t m_index;
 
    public:
     static constexpr auto k_radius{28};
 };
+
+/**
+ * @class ConstNodeData
+ * @brief Read-only handle to one node of a NodeStore, handed out by a const store.
+ *
+ * Copying it keeps it read-only, so const code can't change nodes through it.
+ */
+class ConstNodeData {
+   public:
+    ConstNodeData(const NodeStore& store, NodeIndex_t index);
+
+    QRect getBoundingRect() const;
+
+    NodeIndex_t getIndex() const;
+
+    QColor getFillColor() const;
+
+    const QString& getLabel() const;
+
+    QPoint getPosition() const;
+
+    bool isSelected() const;
+    uint32_t getSelectOrder() const;
+
+    NodeData::State getState() const;
+
+   private:
+    const NodeStore* m_store;
+    NodeIndex_t m_index;
+};
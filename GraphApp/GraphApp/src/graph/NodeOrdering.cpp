@@ -0,0 +1,130 @@
+#include <pch.h>
+
+#include "NodeOrdering.h"
+
+#include "storage/GraphStorageVisitor.h"
+
+static uint64_t hilbertCurveIndex(uint32_t x, uint32_t y) {
+    constexpr uint32_t side = 1u << 16;
+
+    uint64_t index = 0;
+    for (uint32_t half = side / 2; half > 0; half /= 2) {
+        const uint32_t rx = (x & half) ? 1 : 0;
+        const uint32_t ry = (y & half) ? 1 : 0;
+        index += uint64_t{half} * half * ((3 * rx) ^ ry);
+
+        if (ry == 0) {
+            if (rx == 1) {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+
+    return index;
+}
+
+template <typename Callback>
+static void forEachAdjacentNode(const IGraphStorage& storage, NodeIndex_t node,
+                                Callback&& callback) {
+    forEachNeighbour(storage, node, [&](NodeIndex_t neighbour, CostType_t) { callback(neighbour); });
+    forEachIncomingNeighbour(storage, node,
+                             [&](NodeIndex_t neighbour, CostType_t) { callback(neighbour); });
+}
+
+// Visits every component starting from the first unvisited node in starts. When
+// degrees is not empty, the neighbours of a node are queued by increasing degree.
+static std::vector<NodeIndex_t> breadthFirstFrom(const IGraphStorage& storage,
+                                                 std::span<const NodeIndex_t> starts,
+                                                 std::span<const uint32_t> degrees) {
+    std::vector<NodeIndex_t> order;
+    order.reserve(starts.size());
+
+    std::vector<bool> visited(starts.size(), false);
+    std::vector<NodeIndex_t> adjacentNodes;
+
+    for (const auto start : starts) {
+        if (visited[start]) {
+            continue;
+        }
+
+        visited[start] = true;
+        order.push_back(start);
+
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            adjacentNodes.clear();
+            forEachAdjacentNode(storage, order[head], [&](NodeIndex_t neighbour) {
+                if (!visited[neighbour]) {
+                    visited[neighbour] = true;
+                    adjacentNodes.push_back(neighbour);
+                }
+            });
+
+            if (!degrees.empty()) {
+                std::ranges::stable_sort(adjacentNodes, {},
+                                         [&](NodeIndex_t node) { return degrees[node]; });
+            }
+
+            order.insert(order.end(), adjacentNodes.begin(), adjacentNodes.end());
+        }
+    }
+
+    return order;
+}
+
+std::vector<NodeIndex_t> hilbertCurveOrder(std::span<const QPoint> positions) {
+    if (positions.empty()) {
+        return {};
+    }
+
+    const auto [minX, maxX] = std::ranges::minmax(positions | std::views::transform(&QPoint::x));
+    const auto [minY, maxY] = std::ranges::minmax(positions | std::views::transform(&QPoint::y));
+
+    const double scale = 65535.0 / std::max({maxX - minX, maxY - minY, 1});
+
+    std::vector<std::pair<uint64_t, NodeIndex_t>> keys(positions.size());
+    const auto indices =
+        std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(positions.size()));
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t index) {
+        const auto x = static_cast<uint32_t>((positions[index].x() - minX) * scale);
+        const auto y = static_cast<uint32_t>((positions[index].y() - minY) * scale);
+
+        keys[index] = {hilbertCurveIndex(x, y), index};
+    });
+
+    std::sort(std::execution::par, keys.begin(), keys.end());
+
+    std::vector<NodeIndex_t> order(positions.size());
+    std::ranges::transform(keys, order.begin(), &std::pair<uint64_t, NodeIndex_t>::second);
+
+    return order;
+}
+
+std::vector<NodeIndex_t> reverseCuthillMcKeeOrder(const IGraphStorage& storage, size_t nodeCount) {
+    std::vector<uint32_t> degrees(nodeCount, 0);
+    for (NodeIndex_t node = 0; node < nodeCount; ++node) {
+        forEachNeighbour(storage, node, [&](NodeIndex_t neighbour, CostType_t) {
+            ++degrees[node];
+            ++degrees[neighbour];
+        });
+    }
+
+    // Starting every component from its lowest degree node is a cheap stand-in for
+    // a peripheral node.
+    std::vector<NodeIndex_t> starts(nodeCount);
+    std::iota(starts.begin(), starts.end(), NodeIndex_t{0});
+    std::ranges::stable_sort(starts, {}, [&](NodeIndex_t node) { return degrees[node]; });
+
+    auto order = breadthFirstFrom(storage, starts, degrees);
+    std::ranges::reverse(order);
+
+    return order;
+}
+
+std::vector<NodeIndex_t> breadthFirstOrder(const IGraphStorage& storage, size_t nodeCount) {
+    std::vector<NodeIndex_t> starts(nodeCount);
+    std::iota(starts.begin(), starts.end(), NodeIndex_t{0});
+
+    return breadthFirstFrom(storage, starts, {});
+}
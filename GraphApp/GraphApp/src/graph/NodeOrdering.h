@@ -0,0 +1,20 @@
+#pragma once
+
+#include "storage/IGraphStorage.h"
+
+/**
+ * Node permutations that put nodes which are used together next to each other
+ * in memory. Each returns the old node indices in their new order.
+ *
+ * - hilbertCurveOrder: sorts nodes along a Hilbert curve over their positions,
+ *   so nodes close on screen (and, for road maps, in the graph) stay close.
+ * - reverseCuthillMcKeeOrder: breadth first from a low degree node, visiting
+ *   neighbours by increasing degree, then reversed; keeps edge endpoints close.
+ * - breadthFirstOrder: plain breadth first order, component by component.
+ *
+ * Edges are followed in both directions, so oriented graphs are ordered by
+ * their underlying undirected graph.
+ */
+std::vector<NodeIndex_t> hilbertCurveOrder(std::span<const QPoint> positions);
+std::vector<NodeIndex_t> reverseCuthillMcKeeOrder(const IGraphStorage& storage, size_t nodeCount);
+std::vector<NodeIndex_t> breadthFirstOrder(const IGraphStorage& storage, size_t nodeCount);
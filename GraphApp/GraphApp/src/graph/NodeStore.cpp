@@ -0,0 +1,185 @@
+#include <pch.h>
+
+#include "NodeStore.h"
+
+size_t NodeStore::size() const { return m_positions.size(); }
+
+bool NodeStore::empty() const { return m_positions.empty(); }
+
+void NodeStore::reserve(size_t count) {
+    m_positions.reserve(count);
+    m_states.reserve(count);
+    m_fillColors.reserve(count);
+    m_selectOrders.reserve(count);
+    m_stateEpochs.reserve(count);
+}
+
+void NodeStore::clear() {
+    m_positions.clear();
+    m_states.clear();
+    m_fillColors.clear();
+    m_selectOrders.clear();
+    m_stateEpochs.clear();
+    m_labels.clear();
+}
+
+NodeData NodeStore::add(const QPoint& position, QRgb fillColor) {
+    m_positions.push_back(position);
+    m_states.push_back(NodeData::State::NONE);
+    m_fillColors.push_back(fillColor);
+    m_selectOrders.push_back(-1);
+    m_stateEpochs.push_back(m_epoch);
+
+    return (*this)[static_cast<NodeIndex_t>(size() - 1)];
+}
+
+NodeData NodeStore::operator[](NodeIndex_t index) { return NodeData{*this, index}; }
+
+ConstNodeData NodeStore::operator[](NodeIndex_t index) const {
+    return ConstNodeData{*this, index};
+}
+
+std::span<const QPoint> NodeStore::getPositions() const { return m_positions; }
+
+void NodeStore::setPosition(NodeIndex_t index, const QPoint& position) {
+    m_positions[index] = position;
+}
+
+QPoint NodeStore::getPosition(NodeIndex_t index) const { return m_positions[index]; }
+
+void NodeStore::setFillColor(NodeIndex_t index, QRgb color) {
+    refresh(index);
+    m_fillColors[index] = color;
+}
+
+QRgb NodeStore::getFillColor(NodeIndex_t index) const {
+    return isStale(index) ? m_resetFillColor : m_fillColors[index];
+}
+
+void NodeStore::replaceFillColor(QRgb oldColor, QRgb newColor) {
+    std::ranges::replace(m_fillColors, oldColor, newColor);
+    if (m_resetFillColor == oldColor) {
+        m_resetFillColor = newColor;
+    }
+}
+
+void NodeStore::setState(NodeIndex_t index, NodeData::State state) {
+    const auto color = getStateColor(state);
+
+    refresh(index);
+    if (color) {
+        m_fillColors[index] = color.value();
+    }
+    m_states[index] = state;
+}
+
+NodeData::State NodeStore::getState(NodeIndex_t index) const {
+    return isStale(index) ? m_resetState : m_states[index];
+}
+
+void NodeStore::resetStates(NodeData::State state, QRgb fillColor) {
+    m_resetState = state;
+    m_resetFillColor = getStateColor(state).value_or(fillColor);
+
+    // After a wrap around, stamps from 2^32 resets ago would look current again.
+    if (++m_epoch == 0) {
+        std::ranges::fill(m_stateEpochs, 0);
+        m_epoch = 1;
+    }
+}
+
+void NodeStore::select(NodeIndex_t index, uint32_t selectOrder) {
+    m_selectOrders[index] = selectOrder;
+}
+
+void NodeStore::deselect(NodeIndex_t index) { m_selectOrders[index] = -1; }
+
+uint32_t NodeStore::getSelectOrder(NodeIndex_t index) const { return m_selectOrders[index]; }
+
+const QString& NodeStore::getLabel(NodeIndex_t index) const {
+    auto [it, inserted] = m_labels.try_emplace(index);
+    if (inserted) {
+        it->second = QString::number(index);
+    }
+
+    return it->second;
+}
+
+void NodeStore::retainLabels(const QRect& visibleRect) const {
+    std::erase_if(m_labels, [&](const auto& label) {
+        return !visibleRect.intersects(NodeData::getBoundingRect(m_positions[label.first]));
+    });
+}
+
+std::optional<QRgb> NodeStore::getStateColor(NodeData::State state) {
+    using enum NodeData::State;
+
+    switch (state) {
+        case NONE:
+            return std::nullopt;
+        case UNVISITED:
+            return qRgb(150, 150, 150);
+        case VISITED:
+            return qRgb(70, 130, 180);
+        case ANALYZING:
+            return qRgb(255, 165, 0);
+        case ANALYZED:
+            return qRgb(60, 179, 113);
+        case UNREACHABLE:
+            return qRgb(220, 20, 20);
+        default:
+            throw std::runtime_error("Invalid state assignment to NodeData");
+    }
+}
+
+bool NodeStore::isStale(NodeIndex_t index) const { return m_stateEpochs[index] != m_epoch; }
+
+void NodeStore::refresh(NodeIndex_t index) {
+    if (isStale(index)) {
+        m_states[index] = m_resetState;
+        m_fillColors[index] = m_resetFillColor;
+        m_stateEpochs[index] = m_epoch;
+    }
+}
+
+void NodeStore::compact(const std::vector<bool>& removedNodes) {
+    size_t newIndex = 0;
+    for (size_t oldIndex = 0; oldIndex < size(); ++oldIndex) {
+        if (oldIndex < removedNodes.size() && removedNodes[oldIndex]) {
+            continue;
+        }
+
+        m_positions[newIndex] = m_positions[oldIndex];
+        m_states[newIndex] = m_states[oldIndex];
+        m_fillColors[newIndex] = m_fillColors[oldIndex];
+        m_selectOrders[newIndex] = m_selectOrders[oldIndex];
+        m_stateEpochs[newIndex] = m_stateEpochs[oldIndex];
+        ++newIndex;
+    }
+
+    m_positions.resize(newIndex);
+    m_states.resize(newIndex);
+    m_fillColors.resize(newIndex);
+    m_selectOrders.resize(newIndex);
+    m_stateEpochs.resize(newIndex);
+    m_labels.clear();
+}
+
+void NodeStore::permute(std::span<const NodeIndex_t> order) {
+    const auto permuteArray = [order](auto& values) {
+        std::remove_reference_t<decltype(values)> permuted;
+        permuted.reserve(values.capacity());
+        for (const auto oldIndex : order) {
+            permuted.push_back(values[oldIndex]);
+        }
+
+        values = std::move(permuted);
+    };
+
+    permuteArray(m_positions);
+    permuteArray(m_states);
+    permuteArray(m_fillColors);
+    permuteArray(m_selectOrders);
+    permuteArray(m_stateEpochs);
+    m_labels.clear();
+}
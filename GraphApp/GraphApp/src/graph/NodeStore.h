@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Node.h"
+
+/**
+ * @class NodeStore
+ * @brief Per-node attributes of a graph, kept as one array per attribute.
+ *
+ * Storage Format:
+ * - m_positions[i]:    centre of node i
+ * - m_states[i]:       algorithm state of node i
+ * - m_fillColors[i]:   fill colour of node i
+ * - m_selectOrders[i]: order in which node i was selected, -1 when it is not
+ * - m_stateEpochs[i]:  epoch in which the state and fill colour of node i were
+ *                      last written; older entries read as m_resetState and
+ *                      m_resetFillColor instead
+ * - m_labels:          labels of the nodes drawn lately, keyed by node index
+ *
+ * The quad tree and the renderers only read positions and algorithms only
+ * touch states, so each streams through its own array instead of whole node
+ * objects. Labels are the node index as text; they are formatted when a node
+ * gets drawn and dropped once it leaves the view (see retainLabels).
+ *
+ * resetStates() gives every node the same state by starting a new epoch, so
+ * starting or rewinding an algorithm doesn't have to visit each node.
+ */
+class NodeStore {
+   public:
+    size_t size() const;
+    bool empty() const;
+    void reserve(size_t count);
+    void clear();
+
+    NodeData add(const QPoint& position, QRgb fillColor);
+
+    NodeData operator[](NodeIndex_t index);
+    ConstNodeData operator[](NodeIndex_t index) const;
+
+    std::span<const QPoint> getPositions() const;
+    void setPosition(NodeIndex_t index, const QPoint& position);
+    QPoint getPosition(NodeIndex_t index) const;
+
+    void setFillColor(NodeIndex_t index, QRgb color);
+    QRgb getFillColor(NodeIndex_t index) const;
+    void replaceFillColor(QRgb oldColor, QRgb newColor);
+
+    void setState(NodeIndex_t index, NodeData::State state);
+    NodeData::State getState(NodeIndex_t index) const;
+    // fillColor is only used for states without a colour of their own.
+    void resetStates(NodeData::State state, QRgb fillColor);
+
+    void select(NodeIndex_t index, uint32_t selectOrder);
+    void deselect(NodeIndex_t index);
+    uint32_t getSelectOrder(NodeIndex_t index) const;
+
+    const QString& getLabel(NodeIndex_t index) const;
+    void retainLabels(const QRect& visibleRect) const;
+
+    // Keeps the nodes whose flag is not set, in their current order.
+    void compact(const std::vector<bool>& removedNodes);
+    // Node order[i] becomes node i.
+    void permute(std::span<const NodeIndex_t> order);
+
+   private:
+    static std::optional<QRgb> getStateColor(NodeData::State state);
+
+    bool isStale(NodeIndex_t index) const;
+    void refresh(NodeIndex_t index);
+
+    std::vector<QPoint> m_positions{};
+    std::vector<NodeData::State> m_states{};
+    std::vector<QRgb> m_fillColors{};
+    std::vector<uint32_t> m_selectOrders{};
+    std::vector<uint32_t> m_stateEpochs{};
+
+    uint32_t m_epoch{0};
+    NodeData::State m_resetState{NodeData::State::NONE};
+    QRgb m_resetFillColor{};
+
+    mutable std::unordered_map<NodeIndex_t, QString> m_labels{};
+};
@@ -2,263 +2,434 @@
 
 #include "QuadTree.h"
 
-void QuadTree::setBoundary(const QRect& boundary) { m_boundary = boundary; }
+static uint64_t spreadBits(uint64_t value) {
+    value = (value | (value << 16)) & 0x0000FFFF0000FFFF;
+    value = (value | (value << 8)) & 0x00FF00FF00FF00FF;
+    value = (value | (value << 4)) & 0x0F0F0F0F0F0F0F0F;
+    value = (value | (value << 2)) & 0x3333333333333333;
+    value = (value | (value << 1)) & 0x5555555555555555;
+    return value;
+}
+
+static uint64_t mortonCode(uint32_t x, uint32_t y) { return spreadBits(x) | spreadBits(y) << 1; }
+
+static QRect getLooseBoundary(const QRect& boundary) {
+    constexpr auto r = NodeData::k_radius;
+    return boundary.adjusted(-r, -r, r, r);
+}
+
+static uint64_t getDistanceSquared(QPoint lhs, QPoint rhs) {
+    const auto dx = static_cast<int64_t>(lhs.x()) - rhs.x();
+    const auto dy = static_cast<int64_t>(lhs.y()) - rhs.y();
+    return static_cast<uint64_t>(dx * dx) + static_cast<uint64_t>(dy * dy);
+}
+
+// Lower bound for the distance to any center stored below the cell.
+static uint64_t getDistanceSquared(const QRect& boundary, QPoint pos) {
+    return getDistanceSquared(pos, QPoint(std::clamp(pos.x(), boundary.left(), boundary.right()),
+                                          std::clamp(pos.y(), boundary.top(), boundary.bottom())));
+}
+
+void QuadTree::setBoundary(const QRect& boundary) {
+    m_boundary = boundary;
+
+    const auto side = std::bit_ceil(
+        static_cast<uint32_t>(std::max({boundary.width(), boundary.height(), 1})));
+    m_rootBoundary = QRect(boundary.x(), boundary.y(), side, side);
+
+    clear();
+}
 
 const QRect& QuadTree::getBoundary() const { return m_boundary; }
 
 void QuadTree::insert(const NodeData& node) {
-    if (!m_boundary.intersects(node.getBoundingRect())) {
+    const auto pos = node.getPosition();
+    if (!m_boundary.contains(pos)) {
         return;
     }
 
-    if (m_nodes.size() < k_maxSoftCapacity) {
-        m_nodes.emplace_back(node.getIndex(), node.getPosition());
-        return;
+    Index_t treeNode = m_freeNode;
+    if (treeNode != k_invalidIndex) {
+        m_freeNode = m_nodes[treeNode].m_next;
+        m_nodes[treeNode] = {node.getIndex(), pos};
     } else {
-        if (!isSubdivided() && !canSubdivide()) {
-            m_nodes.emplace_back(node.getIndex(), node.getPosition());
-            return;
-        }
+        treeNode = static_cast<Index_t>(m_nodes.size());
+        m_nodes.push_back({node.getIndex(), pos});
     }
 
-    if (!isSubdivided()) {
-        subdivide();
+    if (node.getIndex() >= m_nodeEntries.size()) {
+        m_nodeEntries.resize(node.getIndex() + 1, k_invalidIndex);
     }
 
-    m_northWest->insert(node);
-    m_northEast->insert(node);
-    m_southWest->insert(node);
-    m_southEast->insert(node);
+    m_nodeEntries[node.getIndex()] = treeNode;
+    insertIntoLeaf(findLeaf(pos), treeNode);
 }
 
-void QuadTree::getContainingTrees(const NodeData& node, std::vector<QuadTree*>& trees) {
-    if (!m_boundary.intersects(node.getBoundingRect())) {
-        return;
-    }
+void QuadTree::build(std::span<const QPoint> positions, const std::vector<bool>& skippedNodes) {
+    clear();
 
-    for (size_t i = 0; i < m_nodes.size(); ++i) {
-        if (m_nodes[i].m_index == node.getIndex()) {
-            return trees.push_back(this);
+    m_nodes.reserve(positions.size());
+    for (NodeIndex_t index = 0; index < positions.size(); ++index) {
+        const auto skipped = index < skippedNodes.size() && skippedNodes[index];
+        if (!skipped && m_boundary.contains(positions[index])) {
+            m_nodes.push_back({index, positions[index]});
         }
     }
 
-    if (!isSubdivided()) {
-        return;
-    }
+    // Every cell covers one range of Morton codes, so after sorting the nodes of
+    // a cell form one run of the pool and its children split that run in four.
+    std::sort(std::execution::par, m_nodes.begin(), m_nodes.end(),
+              [this](const TreeNode& lhs, const TreeNode& rhs) {
+                  return getMortonCode(lhs.m_position) < getMortonCode(rhs.m_position);
+              });
 
-    m_northWest->getContainingTrees(node, trees);
-    m_northEast->getContainingTrees(node, trees);
-    m_southWest->getContainingTrees(node, trees);
-    m_southEast->getContainingTrees(node, trees);
-}
+    buildCell(0, 0, static_cast<Index_t>(m_nodes.size()));
 
-void QuadTree::getNodesInArea(const QRect& area, std::vector<bool>& visitMask,
-                              std::vector<NodeIndex_t>& nodes) const {
-    if (!m_boundary.intersects(area)) {
-        return;
+    m_nodeEntries.assign(positions.size(), k_invalidIndex);
+    for (Index_t i = 0; i < m_nodes.size(); ++i) {
+        m_nodeEntries[m_nodes[i].m_index] = i;
     }
+}
 
-    for (size_t i = 0; i < m_nodes.size(); ++i) {
-        const auto index = m_nodes[i].m_index;
-        const auto& nodePos = m_nodes[i].m_position;
-        const QRect nodeArea(nodePos.x() - NodeData::k_radius, nodePos.y() - NodeData::k_radius,
-                             2 * NodeData::k_radius, 2 * NodeData::k_radius);
-
-        if (!visitMask[index] && area.intersects(nodeArea)) {
-            nodes.push_back(index);
-            visitMask[index] = true;
-        }
+void QuadTree::update(const NodeData& node) {
+    const auto treeNode = getTreeNode(node.getIndex());
+    if (treeNode == k_invalidIndex) {
+        return insert(node);
     }
 
-    if (!isSubdivided()) {
+    const auto pos = node.getPosition();
+    m_nodes[treeNode].m_position = pos;
+    if (m_cells[m_nodes[treeNode].m_leaf].m_boundary.contains(pos)) {
         return;
     }
 
-    m_northWest->getNodesInArea(area, visitMask, nodes);
-    m_northEast->getNodesInArea(area, visitMask, nodes);
-    m_southWest->getNodesInArea(area, visitMask, nodes);
-    m_southEast->getNodesInArea(area, visitMask, nodes);
-}
-
-bool QuadTree::needsReinserting(const NodeData& node) const {
-    return !m_boundary.intersects(node.getBoundingRect());
-}
-
-void QuadTree::update(const NodeData& node) {
-    for (size_t i = 0; i < m_nodes.size(); ++i) {
-        if (m_nodes[i].m_index == node.getIndex()) {
-            m_nodes[i].m_position = node.getPosition();
-            return;
-        }
+    unlinkFromLeaf(treeNode);
+    if (!m_boundary.contains(pos)) {
+        m_nodes[treeNode].m_next = std::exchange(m_freeNode, treeNode);
+        m_nodeEntries[node.getIndex()] = k_invalidIndex;
+        return;
     }
+
+    insertIntoLeaf(findLeaf(pos), treeNode);
 }
 
 void QuadTree::remove(const NodeData& node) {
-    for (size_t i = 0; i < m_nodes.size(); ++i) {
-        if (m_nodes[i].m_index == node.getIndex()) {
-            m_nodes[i] = m_nodes[m_nodes.size() - 1];
-            m_nodes.pop_back();
-            return;
-        }
+    const auto treeNode = getTreeNode(node.getIndex());
+    if (treeNode == k_invalidIndex) {
+        return;
     }
+
+    unlinkFromLeaf(treeNode);
+    m_nodes[treeNode].m_next = std::exchange(m_freeNode, treeNode);
+    m_nodeEntries[node.getIndex()] = k_invalidIndex;
 }
 
 void QuadTree::clear() {
+    m_cells.clear();
     m_nodes.clear();
+    m_nodeEntries.clear();
+    m_freeNode = k_invalidIndex;
 
-    m_northWest.reset();
-    m_northEast.reset();
-    m_southWest.reset();
-    m_southEast.reset();
+    m_cells.push_back({m_rootBoundary});
 }
 
-void QuadTree::subdivide() {
-    const auto x = m_boundary.x();
-    const auto y = m_boundary.y();
-    const auto w = m_boundary.width() / 2;
-    const auto h = m_boundary.height() / 2;
+void QuadTree::getNodesInArea(const QRect& area, std::vector<NodeIndex_t>& nodes) const {
+    forEachLeaf(
+        [&](const Cell_t& cell) { return getLooseBoundary(cell.m_boundary).intersects(area); },
+        [&](const Cell_t& cell) {
+            for (auto i = cell.m_firstNode; i != k_invalidIndex; i = m_nodes[i].m_next) {
+                if (area.intersects(NodeData::getBoundingRect(m_nodes[i].m_position))) {
+                    nodes.push_back(m_nodes[i].m_index);
+                }
+            }
+
+            return false;
+        });
+}
 
-    if (!canSubdivide()) {
-        throw std::runtime_error("Cannot subdivide QuadTree further.");
-    }
+void QuadTree::getCellsInArea(const QRect& area, std::vector<QRect>& cells) const {
+    forEachLeaf(
+        [&](const Cell_t& cell) {
+            // The root square overhangs the boundary, which is all that gets reported.
+            const auto boundary = cell.m_boundary.intersected(m_boundary);
+            if (boundary.isEmpty() || !boundary.intersects(area)) {
+                return false;
+            }
 
-    m_northWest = std::make_unique<QuadTree>();
-    m_northWest->setBoundary(QRect(x, y, w, h));
+            cells.push_back(boundary);
+            return true;
+        },
+        [](const Cell_t&) { return false; });
+}
 
-    m_northEast = std::make_unique<QuadTree>();
-    m_northEast->setBoundary(QRect(x + w, y, w, h));
+bool QuadTree::intersectsAnotherNode(QPoint pos, float minDistance,
+                                     NodeIndex_t indexToIgnore) const {
+    const auto minDistanceSquared = minDistance * minDistance;
+
+    return forEachLeaf(
+        [&](const Cell_t& cell) {
+            return getDistanceSquared(cell.m_boundary, pos) < minDistanceSquared;
+        },
+        [&](const Cell_t& cell) {
+            for (auto i = cell.m_firstNode; i != k_invalidIndex; i = m_nodes[i].m_next) {
+                if (m_nodes[i].m_index != indexToIgnore &&
+                    getDistanceSquared(m_nodes[i].m_position, pos) < minDistanceSquared) {
+                    return true;
+                }
+            }
+
+            return false;
+        });
+}
 
-    m_southWest = std::make_unique<QuadTree>();
-    m_southWest->setBoundary(QRect(x, y + h, w, h));
+std::optional<NodeIndex_t> QuadTree::getNodeAtPosition(QPoint pos, float minDistance,
+                                                       NodeIndex_t indexToIgnore) const {
+    Neighbour_t closestNode;
+    if (getNearestNodes(pos, minDistance, {&closestNode, 1}, indexToIgnore) == 0) {
+        return std::nullopt;
+    }
 
-    m_southEast = std::make_unique<QuadTree>();
-    m_southEast->setBoundary(QRect(x + w, y + h, w, h));
+    return closestNode.m_index;
 }
 
-bool QuadTree::isSubdivided() const { return m_northWest != nullptr; }
+size_t QuadTree::getNearestNodes(QPoint pos, float maxDistance, std::span<Neighbour_t> neighbours,
+                                 NodeIndex_t indexToIgnore) const {
+    if (neighbours.empty()) {
+        return 0;
+    }
 
-bool QuadTree::canSubdivide() const {
-    return m_boundary.width() / 2 > NodeData::k_radius &&
-           m_boundary.height() / 2 > NodeData::k_radius;
-}
+    // Cells are expanded nearest first, and the search stops at the first cell
+    // farther away than the k-th node found so far.
+    thread_local std::vector<std::pair<uint64_t, Index_t>> queue;
+    queue.clear();
+    queue.emplace_back(getDistanceSquared(m_cells[0].m_boundary, pos), 0);
+
+    const auto maxDistanceSquared = static_cast<uint64_t>(maxDistance * maxDistance);
+    size_t found = 0;
+    const auto bound = [&]() {
+        return found == neighbours.size() ? neighbours.back().m_distanceSquared
+                                          : maxDistanceSquared;
+    };
+
+    while (!queue.empty()) {
+        std::ranges::pop_heap(queue, std::greater{});
+        const auto [cellDistanceSquared, cellIndex] = queue.back();
+        queue.pop_back();
+
+        if (cellDistanceSquared >= bound()) {
+            break;
+        }
 
-const QuadTreePtr_t& QuadTree::getNorthWest() const { return m_northWest; }
+        const auto& cell = m_cells[cellIndex];
+        if (!cell.isLeaf()) {
+            for (auto child = cell.m_firstChild; child < cell.m_firstChild + 4; ++child) {
+                const auto distanceSquared = getDistanceSquared(m_cells[child].m_boundary, pos);
+                if (distanceSquared < bound()) {
+                    queue.emplace_back(distanceSquared, child);
+                    std::ranges::push_heap(queue, std::greater{});
+                }
+            }
 
-const QuadTreePtr_t& QuadTree::getNorthEast() const { return m_northEast; }
+            continue;
+        }
 
-const QuadTreePtr_t& QuadTree::getSouthWest() const { return m_southWest; }
+        for (auto i = cell.m_firstNode; i != k_invalidIndex; i = m_nodes[i].m_next) {
+            const auto distanceSquared = getDistanceSquared(m_nodes[i].m_position, pos);
+            if (m_nodes[i].m_index == indexToIgnore || distanceSquared >= bound()) {
+                continue;
+            }
 
-const QuadTreePtr_t& QuadTree::getSouthEast() const { return m_southEast; }
+            // Insertion into the sorted prefix, dropping the farthest one when full.
+            found = std::min(found + 1, neighbours.size());
+            auto slot = found - 1;
+            for (; slot > 0 && neighbours[slot - 1].m_distanceSquared > distanceSquared; --slot) {
+                neighbours[slot] = neighbours[slot - 1];
+            }
 
-bool QuadTree::intersectsAnotherNode(QPoint pos, float minDistance,
-                                     NodeIndex_t indexToIgnore) const {
-    if (!m_boundary.intersects(QRect(pos.x() - NodeData::k_radius, pos.y() - NodeData::k_radius,
-                                     2 * NodeData::k_radius, 2 * NodeData::k_radius))) {
-        return false;
+            neighbours[slot] = {m_nodes[i].m_index, distanceSquared};
+        }
     }
 
-    for (size_t i = 0; i < m_nodes.size(); ++i) {
-        if (m_nodes[i].m_index == indexToIgnore) {
+    return found;
+}
+
+void QuadTree::getNodesInRadius(QPoint pos, float radius, std::vector<NodeIndex_t>& nodes) const {
+    const auto radiusSquared = static_cast<uint64_t>(radius * radius);
+
+    forEachLeaf(
+        [&](const Cell_t& cell) {
+            return getDistanceSquared(cell.m_boundary, pos) < radiusSquared;
+        },
+        [&](const Cell_t& cell) {
+            for (auto i = cell.m_firstNode; i != k_invalidIndex; i = m_nodes[i].m_next) {
+                if (getDistanceSquared(m_nodes[i].m_position, pos) < radiusSquared) {
+                    nodes.push_back(m_nodes[i].m_index);
+                }
+            }
+
+            return false;
+        });
+}
+
+// Visits every leaf below the cells enterCell accepts, stopping early once
+// visitLeaf returns true. Returns whether it stopped early.
+template <typename Enter_t, typename Visit_t>
+bool QuadTree::forEachLeaf(const Enter_t& enterCell, const Visit_t& visitLeaf) const {
+    std::array<Index_t, k_maxTraversalStack> stack;
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const auto& cell = m_cells[stack[--stackSize]];
+        if (!enterCell(cell)) {
             continue;
         }
 
-        const auto nodePos = m_nodes[i].m_position;
+        if (cell.isLeaf()) {
+            if (visitLeaf(cell)) {
+                return true;
+            }
 
-        const int64_t dx = nodePos.x() - pos.x();
-        const int64_t dy = nodePos.y() - pos.y();
+            continue;
+        }
 
-        if (dx * dx + dy * dy < (minDistance * minDistance)) {
-            return true;
+        // Pushed in reverse so the children are visited north west first.
+        for (Index_t child = 4; child-- > 0;) {
+            stack[stackSize++] = cell.m_firstChild + child;
         }
     }
 
-    if (!isSubdivided()) {
-        return false;
-    }
+    return false;
+}
 
-    if (m_northWest->intersectsAnotherNode(pos, minDistance, indexToIgnore)) {
-        return true;
+QuadTree::Index_t QuadTree::findLeaf(QPoint pos) const {
+    Index_t leaf = 0;
+    while (!m_cells[leaf].isLeaf()) {
+        leaf = getChild(leaf, pos);
     }
 
-    if (m_northEast->intersectsAnotherNode(pos, minDistance, indexToIgnore)) {
-        return true;
-    }
+    return leaf;
+}
 
-    if (m_southWest->intersectsAnotherNode(pos, minDistance, indexToIgnore)) {
-        return true;
-    }
+QuadTree::Index_t QuadTree::getTreeNode(NodeIndex_t index) const {
+    return index < m_nodeEntries.size() ? m_nodeEntries[index] : k_invalidIndex;
+}
 
-    if (m_southEast->intersectsAnotherNode(pos, minDistance, indexToIgnore)) {
-        return true;
+void QuadTree::insertIntoLeaf(Index_t leaf, Index_t node) {
+    auto& cell = m_cells[leaf];
+    auto& treeNode = m_nodes[node];
+    treeNode.m_leaf = leaf;
+    treeNode.m_previous = k_invalidIndex;
+    treeNode.m_next = cell.m_firstNode;
+
+    if (cell.m_firstNode != k_invalidIndex) {
+        m_nodes[cell.m_firstNode].m_previous = node;
     }
 
-    return false;
+    cell.m_firstNode = node;
+    ++cell.m_nodeCount;
+
+    if (cell.m_nodeCount > k_maxSoftCapacity && canSubdivide(leaf)) {
+        subdivide(leaf);
+    }
 }
 
-std::optional<NodeIndex_t> QuadTree::getNodeAtPosition(QPoint pos, float minDistance,
-                                                       NodeIndex_t indexToIgnore) const {
-    const auto minDistanceSquared = static_cast<uint64_t>(minDistance * minDistance);
-    const auto closestNode = getClosestNodeHelper(pos, minDistanceSquared, indexToIgnore);
-    if (closestNode) {
-        return closestNode->first;
+void QuadTree::unlinkFromLeaf(Index_t node) {
+    const auto& treeNode = m_nodes[node];
+    auto& cell = m_cells[treeNode.m_leaf];
+
+    if (treeNode.m_previous != k_invalidIndex) {
+        m_nodes[treeNode.m_previous].m_next = treeNode.m_next;
+    } else {
+        cell.m_firstNode = treeNode.m_next;
+    }
+
+    if (treeNode.m_next != k_invalidIndex) {
+        m_nodes[treeNode.m_next].m_previous = treeNode.m_previous;
     }
 
-    return std::nullopt;
+    --cell.m_nodeCount;
 }
 
-std::optional<std::pair<NodeIndex_t, uint64_t>> QuadTree::getClosestNodeHelper(
-    QPoint pos, uint64_t minDistanceSquared, NodeIndex_t indexToIgnore) const {
-    if (!m_boundary.intersects(QRect(pos.x() - NodeData::k_radius, pos.y() - NodeData::k_radius,
-                                     2 * NodeData::k_radius, 2 * NodeData::k_radius))) {
-        return std::nullopt;
-    }
+void QuadTree::buildCell(Index_t cell, Index_t begin, Index_t end) {
+    if (end - begin <= k_maxSoftCapacity || !canSubdivide(cell)) {
+        auto& leaf = m_cells[cell];
+        leaf.m_firstNode = begin < end ? begin : k_invalidIndex;
+        leaf.m_nodeCount = end - begin;
 
-    NodeIndex_t closestNode = INVALID_NODE;
-    for (size_t i = 0; i < m_nodes.size(); ++i) {
-        if (m_nodes[i].m_index == indexToIgnore) {
-            continue;
+        for (auto i = begin; i < end; ++i) {
+            m_nodes[i].m_leaf = cell;
+            m_nodes[i].m_previous = i > begin ? i - 1 : k_invalidIndex;
+            m_nodes[i].m_next = i + 1 < end ? i + 1 : k_invalidIndex;
         }
 
-        const auto nodePos = m_nodes[i].m_position;
-        const auto dx = static_cast<int64_t>(nodePos.x()) - pos.x();
-        const auto dy = static_cast<int64_t>(nodePos.y()) - pos.y();
-        const auto distanceSq = static_cast<uint64_t>(dx) * dx + static_cast<uint64_t>(dy) * dy;
+        return;
+    }
 
-        if (distanceSq < minDistanceSquared) {
-            closestNode = m_nodes[i].m_index;
-            minDistanceSquared = distanceSq;
-        }
+    subdivide(cell);
+
+    const auto& boundary = m_cells[cell].m_boundary;
+    const auto childArea = uint64_t{static_cast<uint32_t>(boundary.width() / 2)} *
+                           static_cast<uint32_t>(boundary.width() / 2);
+    const auto firstCode = getMortonCode(boundary.topLeft());
+    const auto firstChild = m_cells[cell].m_firstChild;
+
+    auto childBegin = begin;
+    for (Index_t child = 0; child < 4; ++child) {
+        const auto endCode = firstCode + (child + 1) * childArea;
+        const auto childEnd = static_cast<Index_t>(
+            std::partition_point(m_nodes.begin() + childBegin, m_nodes.begin() + end,
+                                 [&](const TreeNode& node) {
+                                     return getMortonCode(node.m_position) < endCode;
+                                 }) -
+            m_nodes.begin());
+
+        buildCell(firstChild + child, childBegin, childEnd);
+        childBegin = childEnd;
     }
+}
 
-    if (isSubdivided()) {
-        auto value = m_northWest->getClosestNodeHelper(pos, minDistanceSquared, indexToIgnore);
-        if (value && value->second < minDistanceSquared) {
-            minDistanceSquared = value->second;
-            closestNode = value->first;
-        }
+// Moves the nodes of the leaf down into its new children.
+void QuadTree::subdivide(Index_t cell) {
+    const auto boundary = m_cells[cell].m_boundary;
+    const auto x = boundary.x();
+    const auto y = boundary.y();
+    const auto half = boundary.width() / 2;
 
-        value = m_northEast->getClosestNodeHelper(pos, minDistanceSquared, indexToIgnore);
-        if (value && value->second < minDistanceSquared) {
-            minDistanceSquared = value->second;
-            closestNode = value->first;
-        }
+    if (!canSubdivide(cell)) {
+        throw std::runtime_error("Cannot subdivide QuadTree further.");
+    }
 
-        value = m_southWest->getClosestNodeHelper(pos, minDistanceSquared, indexToIgnore);
-        if (value && value->second < minDistanceSquared) {
-            minDistanceSquared = value->second;
-            closestNode = value->first;
-        }
+    const auto firstChild = static_cast<Index_t>(m_cells.size());
+    m_cells.push_back({QRect(x, y, half, half)});
+    m_cells.push_back({QRect(x + half, y, half, half)});
+    m_cells.push_back({QRect(x, y + half, half, half)});
+    m_cells.push_back({QRect(x + half, y + half, half, half)});
 
-        value = m_southEast->getClosestNodeHelper(pos, minDistanceSquared, indexToIgnore);
-        if (value && value->second < minDistanceSquared) {
-            minDistanceSquared = value->second;
-            closestNode = value->first;
-        }
-    }
+    m_cells[cell].m_firstChild = firstChild;
+    m_cells[cell].m_nodeCount = 0;
 
-    if (closestNode == INVALID_NODE) {
-        return std::nullopt;
+    auto node = std::exchange(m_cells[cell].m_firstNode, k_invalidIndex);
+    while (node != k_invalidIndex) {
+        const auto next = m_nodes[node].m_next;
+        insertIntoLeaf(getChild(cell, m_nodes[node].m_position), node);
+        node = next;
     }
+}
+
+bool QuadTree::canSubdivide(Index_t cell) const {
+    return m_cells[cell].m_boundary.width() / 2 > NodeData::k_radius;
+}
+
+QuadTree::Index_t QuadTree::getChild(Index_t cell, QPoint pos) const {
+    const auto& boundary = m_cells[cell].m_boundary;
+    const auto half = boundary.width() / 2;
+    const Index_t east = pos.x() >= boundary.x() + half ? 1 : 0;
+    const Index_t south = pos.y() >= boundary.y() + half ? 1 : 0;
+
+    return m_cells[cell].m_firstChild + east + 2 * south;
+}
 
-    return std::make_pair(closestNode, minDistanceSquared);
+uint64_t QuadTree::getMortonCode(QPoint pos) const {
+    return mortonCode(pos.x() - m_rootBoundary.x(), pos.y() - m_rootBoundary.y());
 }
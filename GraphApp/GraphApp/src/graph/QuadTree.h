@@ -2,56 +2,110 @@
 
 #include "Node.h"
 
-using QuadTreePtr_t = std::unique_ptr<class QuadTree>;
-
+/**
+ * @class QuadTree
+ * @brief Loose quad tree over node positions, stored as flat arrays.
+ *
+ * Every node lives in exactly one leaf, the one containing its center. A cell
+ * therefore holds nodes reaching up to NodeData::k_radius past its boundary, so
+ * area queries test cells against the boundary grown by that radius. No node is
+ * stored twice and queries don't need to deduplicate their results.
+ *
+ * Storage Format:
+ * - m_cells: every cell of the tree, the root first; the four children of a cell
+ *            are adjacent, in north west, north east, south west, south east order
+ * - m_nodes: pool of the nodes of all leaves; a leaf lists its nodes in a doubly
+ *            linked list, and freed entries are chained into m_freeNode
+ * - m_nodeEntries: pool entry of every node index, k_invalidIndex if it isn't
+ *                  in the tree; with TreeNode::m_leaf it lets a node be moved
+ *                  or removed without searching for it
+ *
+ * The root is the smallest power of two square covering the boundary, so every
+ * cell is one range of Morton codes. build() sorts the nodes by that code, which
+ * leaves the nodes of each leaf next to each other in the pool.
+ *
+ * Queries walk the cells with a fixed size stack instead of recursing, and
+ * clearing or rebuilding reuses the capacity of both arrays.
+ */
 class QuadTree {
    public:
+    struct Neighbour_t {
+        NodeIndex_t m_index;
+        uint64_t m_distanceSquared;
+    };
+
+    // Also clears the tree.
     void setBoundary(const QRect& boundary);
     const QRect& getBoundary() const;
 
     void insert(const NodeData& node);
-    void getContainingTrees(const NodeData& node, std::vector<QuadTree*>& trees);
-    void getNodesInArea(const QRect& area, std::vector<bool>& visitMask,
-                        std::vector<NodeIndex_t>& nodes) const;
-
-    // NON-RECURSIVE METHODS
-    bool needsReinserting(const NodeData& node) const;
+    // Replaces the contents with node i at positions[i] for every i, except the
+    // nodes flagged in skippedNodes (indices past its end are not skipped).
+    void build(std::span<const QPoint> positions, const std::vector<bool>& skippedNodes = {});
+    // Follows the node to its current position. Only leaving its leaf relinks it.
     void update(const NodeData& node);
     void remove(const NodeData& node);
     void clear();
 
-    void subdivide();
-    bool isSubdivided() const;
-    bool canSubdivide() const;
-
-    const QuadTreePtr_t& getNorthWest() const;
-    const QuadTreePtr_t& getNorthEast() const;
-    const QuadTreePtr_t& getSouthWest() const;
-    const QuadTreePtr_t& getSouthEast() const;
+    void getNodesInArea(const QRect& area, std::vector<NodeIndex_t>& nodes) const;
+    // Boundaries of every cell, inner ones included, that intersect the area.
+    void getCellsInArea(const QRect& area, std::vector<QRect>& cells) const;
 
     bool intersectsAnotherNode(QPoint pos, float minDistance, NodeIndex_t indexToIgnore = -1) const;
     std::optional<NodeIndex_t> getNodeAtPosition(QPoint pos, float minDistance,
                                                  NodeIndex_t indexToIgnore = -1) const;
+    // Fills the buffer with the nodes closer than maxDistance, nearest first, and
+    // returns how many were found. Asks for as many nodes as the buffer holds.
+    size_t getNearestNodes(QPoint pos, float maxDistance, std::span<Neighbour_t> neighbours,
+                           NodeIndex_t indexToIgnore = -1) const;
+    // Appends every node closer than the radius, in no particular order.
+    void getNodesInRadius(QPoint pos, float radius, std::vector<NodeIndex_t>& nodes) const;
 
    private:
-    struct TreeNode {
-        TreeNode(NodeIndex_t index, QPoint position) : m_index(index), m_position(position) {}
+    using Index_t = uint32_t;
+    static constexpr auto k_invalidIndex = std::numeric_limits<Index_t>::max();
 
+    struct Cell_t {
+        QRect m_boundary;
+        Index_t m_firstChild{k_invalidIndex};
+        Index_t m_firstNode{k_invalidIndex};
+        Index_t m_nodeCount{0};
+
+        bool isLeaf() const { return m_firstChild == k_invalidIndex; }
+    };
+
+    struct TreeNode {
         NodeIndex_t m_index;
         QPoint m_position;
+        Index_t m_leaf{k_invalidIndex};
+        Index_t m_previous{k_invalidIndex};
+        Index_t m_next{k_invalidIndex};
     };
 
-    std::optional<std::pair<NodeIndex_t, uint64_t>> getClosestNodeHelper(
-        QPoint pos, uint64_t minDistanceSquared, NodeIndex_t indexToIgnore) const;
+    template <typename Enter_t, typename Visit_t>
+    bool forEachLeaf(const Enter_t& enterCell, const Visit_t& visitLeaf) const;
 
-    QRect m_boundary{};
+    Index_t findLeaf(QPoint pos) const;
+    Index_t getTreeNode(NodeIndex_t index) const;
+    void insertIntoLeaf(Index_t leaf, Index_t node);
+    void unlinkFromLeaf(Index_t node);
+
+    void buildCell(Index_t cell, Index_t begin, Index_t end);
+    void subdivide(Index_t cell);
+    bool canSubdivide(Index_t cell) const;
+    Index_t getChild(Index_t cell, QPoint pos) const;
+    uint64_t getMortonCode(QPoint pos) const;
 
-    QuadTreePtr_t m_northWest{};
-    QuadTreePtr_t m_northEast{};
-    QuadTreePtr_t m_southWest{};
-    QuadTreePtr_t m_southEast{};
+    QRect m_boundary{};
+    QRect m_rootBoundary{};
 
+    std::vector<Cell_t> m_cells{};
     std::vector<TreeNode> m_nodes{};
+    std::vector<Index_t> m_nodeEntries{};
+    Index_t m_freeNode{k_invalidIndex};
 
     static constexpr auto k_maxSoftCapacity{8};
+    // Every traversal step pops one cell and pushes at most four, and the tree is
+    // at most 31 levels deep since a cell side has to stay above NodeData::k_radius.
+    static constexpr size_t k_maxTraversalStack{128};
 };
@@ -12,10 +12,10 @@ IAlgorithm::~IAlgorithm() { m_graph->getGraphManager().unregisterAlgorithm(this)
 
 void IAlgorithm::setNodeState(NodeIndex_t nodeIndex, NodeData::State state) {
     auto& graphManager = m_graph->getGraphManager();
-    auto& node = graphManager.getNode(nodeIndex);
+    auto node = graphManager.getNode(nodeIndex);
 
     node.setState(state);
-    graphManager.update(node.getBoundingRect());
+    graphManager.invalidate(node.getBoundingRect());
 }
 
 NodeData::State IAlgorithm::getNodeState(NodeIndex_t nodeIndex) const {
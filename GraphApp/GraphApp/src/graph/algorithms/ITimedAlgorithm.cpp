@@ -49,18 +49,13 @@ void ITimedAlgorithm::stepAll() {
 }
 
 void ITimedAlgorithm::markAllNodesUnvisited() {
-    const auto nodeCount = static_cast<NodeIndex_t>(m_graph->getGraphManager().getNodesCount());
-    for (NodeIndex_t i = 0; i < nodeCount; ++i) {
-        setNodeState(i, NodeData::State::UNVISITED);
-    }
+    m_graph->getGraphManager().resetNodeStates(NodeData::State::UNVISITED,
+                                               m_graph->getDefaultNodeColor());
 }
 
 void ITimedAlgorithm::unmarkAllNodes() {
-    const auto nodeCount = static_cast<NodeIndex_t>(m_graph->getGraphManager().getNodesCount());
-    for (NodeIndex_t i = 0; i < nodeCount; ++i) {
-        m_graph->getGraphManager().getNode(i).setFillColor(m_graph->getDefaultNodeColor());
-        setNodeState(i, NodeData::State::NONE);
-    }
+    m_graph->getGraphManager().resetNodeStates(NodeData::State::NONE,
+                                               m_graph->getDefaultNodeColor());
 }
 
 void ITimedAlgorithm::onTimerTimeout() {
@@ -2,6 +2,7 @@
 
 #include "ConnectedComponents.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
 #include "../random/Random.h"
 
 static constexpr auto CC_PSEUDOCODE_PRIORITY = 1;
@@ -16,6 +17,13 @@ ConnectedComponents::ConnectedComponents(Graph* graph) : DepthFirstTotalTraversa
 }
 
 bool ConnectedComponents::step() {
+    if (m_stepDelay == 0 && m_connectedComponents.empty() &&
+        m_currentConnectedComponent.size() <= 1 &&
+        m_graph->getGraphManager().getGraphStorage()->type() == IGraphStorage::Type::BIT_MATRIX) {
+        runBitParallel();
+        return false;
+    }
+
     if (m_traversalContainer.empty()) {
         if (!m_currentConnectedComponent.empty()) {
             colorCurrentConnectedComponent();
@@ -129,13 +137,13 @@ void ConnectedComponents::colorCurrentConnectedComponent() {
     std::unordered_set<NodeIndex_t> componentSet(m_currentConnectedComponent.begin(),
                                                  m_currentConnectedComponent.end());
     for (const auto nodeIndex : m_currentConnectedComponent) {
-        auto& node = graphManager.getNode(nodeIndex);
+        auto node = graphManager.getNode(nodeIndex);
 
         node.setFillColor(color);
-        graphManager.update(node.getBoundingRect());
+        graphManager.invalidate(node.getBoundingRect());
 
-        graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-            nodeIndex, [&](NodeIndex_t neighbour, CostType_t) {
+        forEachNeighbour(
+            *graphManager.getGraphStorage(), nodeIndex, [&](NodeIndex_t neighbour, CostType_t) {
                 if (componentSet.contains(neighbour)) {
                     graphManager.addAlgorithmEdge(nodeIndex, neighbour, algPathEntry);
                 }
@@ -146,6 +154,22 @@ void ConnectedComponents::colorCurrentConnectedComponent() {
     m_pseudocodeForm.highlight({13}, CC_PSEUDOCODE_PRIORITY);
 }
 
+void ConnectedComponents::runBitParallel() {
+    const auto& bitMatrix =
+        static_cast<const BitMatrix&>(*m_graph->getGraphManager().getGraphStorage());
+
+    for (auto& component : bitMatrix.reachableComponents(m_startNode)) {
+        for (const auto node : component) {
+            setNodeState(node, NodeData::State::ANALYZED);
+        }
+
+        m_currentConnectedComponent = std::move(component);
+        colorCurrentConnectedComponent();
+    }
+
+    m_traversalContainer.clear();
+}
+
 void ConnectedComponents::onPickedNewStartNode(NodeIndex_t startNode) {
     m_currentConnectedComponent.push_back(startNode);
 
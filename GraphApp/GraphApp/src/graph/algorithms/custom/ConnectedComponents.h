@@ -18,6 +18,7 @@ class ConnectedComponents final : public DepthFirstTotalTraversal {
     void resetForUndo() override;
 
     void colorCurrentConnectedComponent();
+    void runBitParallel();
 
     void onPickedNewStartNode(NodeIndex_t startNode);
     void onVisitedNode(NodeIndex_t node);
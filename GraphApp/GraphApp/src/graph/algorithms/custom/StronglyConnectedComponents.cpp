@@ -2,7 +2,7 @@
 
 #include "StronglyConnectedComponents.h"
 
-#include "../form/main_window/GraphApp.h"
+#include "../graph/storage/GraphStorageVisitor.h"
 #include "../random/Random.h"
 
 StronglyConnectedComponents::StronglyConnectedComponents(Graph* graph)
@@ -56,17 +56,11 @@ void StronglyConnectedComponents::resetForUndo() {
 
 void StronglyConnectedComponents::onFirstTraversalFinished() {
     m_pseudocodeForm.highlight({4});
-    const auto invertedGraph = m_graph->getInvertedGraph();
-    if (!invertedGraph) {
-        throw std::runtime_error("Failed to get inverted graph for SCC.");
-    }
-
-    const auto window = new GraphApp(nullptr);
-    window->setAttribute(Qt::WA_DeleteOnClose);
-    window->setGraph(invertedGraph);
-    window->show();
+    m_graph->getGraphManager().clearAlgorithmPath(DepthFirstTraversal::ANALYZED_EDGE);
 
-    m_invertedDepthTraversal = new CustomDepthFirstTraversal(invertedGraph);
+    // The second traversal runs on the graph itself, following incoming edges
+    // instead of building the inverted graph as a separate copy.
+    m_invertedDepthTraversal = new CustomDepthFirstTraversal(m_graph);
 
     connect(m_invertedDepthTraversal, &IAlgorithm::finished, this,
             &StronglyConnectedComponents::onSecondTraversalFinished);
@@ -103,13 +97,13 @@ void StronglyConnectedComponents::colorStronglyConnectedComponent(
 
     std::unordered_set<NodeIndex_t> componentSet(component.begin(), component.end());
     for (const auto nodeIndex : component) {
-        auto& node = graphManager.getNode(nodeIndex);
+        auto node = graphManager.getNode(nodeIndex);
 
         node.setFillColor(color);
-        graphManager.update(node.getBoundingRect());
+        graphManager.invalidate(node.getBoundingRect());
 
-        graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-            nodeIndex, [&](NodeIndex_t neighbour, CostType_t) {
+        forEachNeighbour(
+            *graphManager.getGraphStorage(), nodeIndex, [&](NodeIndex_t neighbour, CostType_t) {
                 if (componentSet.contains(neighbour)) {
                     graphManager.addAlgorithmEdge(nodeIndex, neighbour, algPathEntry);
                 }
@@ -125,6 +119,8 @@ void StronglyConnectedComponents::colorAnalyzedNodes() {
 
 StronglyConnectedComponents::CustomDepthFirstTraversal::CustomDepthFirstTraversal(Graph* graph)
     : DepthFirstTraversal(graph) {
+    m_followIncomingEdges = true;
+
     connect(this, &IAlgorithm::analyzedNode, this, &CustomDepthFirstTraversal::onNodeAnalyzed);
 }
 
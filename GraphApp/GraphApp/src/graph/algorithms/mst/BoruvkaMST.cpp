@@ -2,6 +2,8 @@
 
 #include "BoruvkaMST.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
+
 BoruvkaMST::BoruvkaMST(Graph* graph) : ITimedAlgorithm(graph) {
     const auto nodeCount = graph->getGraphManager().getNodesCount();
 
@@ -22,6 +24,7 @@ bool BoruvkaMST::step() {
     }
 
     auto& graphManager = m_graph->getGraphManager();
+    const auto& graphStorage = *graphManager.getGraphStorage();
     if (m_shouldPickEdges) {
         std::vector<std::pair<NodeIndex_t, NodeIndex_t>> chosenEdges;
         for (auto& component : m_components) {
@@ -32,8 +35,8 @@ bool BoruvkaMST::step() {
             for (auto nodeIndex : component.m_nodes) {
                 NodeIndex_t representative = m_disjointSet->find(nodeIndex);
 
-                graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-                    nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
+                forEachNeighbour(
+                    graphStorage, nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
                         NodeIndex_t neighbourRepresentative = m_disjointSet->find(neighbourIndex);
                         const bool inSameComponent = representative == neighbourRepresentative;
                         if (inSameComponent) {
@@ -2,6 +2,7 @@
 
 #include "GenericMST.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
 #include "../random/Random.h"
 
 GenericMST::GenericMST(Graph* graph) : ITimedAlgorithm(graph) {
@@ -40,16 +41,16 @@ bool GenericMST::step() {
     NodeIndex_t bestNode = INVALID_NODE, bestNeighbour = INVALID_NODE;
     CostType_t bestCost = std::numeric_limits<CostType_t>::max();
 
+    const auto& graphStorage = *m_graph->getGraphManager().getGraphStorage();
     for (const auto nodeIndex : randomComponent.m_nodes) {
-        m_graph->getGraphManager().getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-            nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
-                const auto neighbourRepresentative = m_disjointSet->find(neighbourIndex);
-                if (representative != neighbourRepresentative && cost < bestCost) {
-                    bestCost = cost;
-                    bestNode = nodeIndex;
-                    bestNeighbour = neighbourIndex;
-                }
-            });
+        forEachNeighbour(graphStorage, nodeIndex, [&](NodeIndex_t neighbourIndex, CostType_t cost) {
+            const auto neighbourRepresentative = m_disjointSet->find(neighbourIndex);
+            if (representative != neighbourRepresentative && cost < bestCost) {
+                bestCost = cost;
+                bestNode = nodeIndex;
+                bestNeighbour = neighbourIndex;
+            }
+        });
     }
 
     if (bestNode == INVALID_NODE || bestNeighbour == INVALID_NODE) {
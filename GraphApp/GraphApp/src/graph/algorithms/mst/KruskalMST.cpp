@@ -2,6 +2,8 @@
 
 #include "KruskalMST.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
+
 KruskalMST::KruskalMST(Graph* graph) : ITimedAlgorithm(graph) {
     sortEdgesByCost();
     m_disjointSet = std::make_unique<DisjointSet>(m_graph->getGraphManager().getNodesCount());
@@ -83,11 +85,11 @@ void KruskalMST::sortEdgesByCost() {
     const auto n = m_graph->getGraphManager().getNodesCount();
     m_sortedEdges.reserve(n * (n - 1) / 2);
 
+    const auto& graphStorage = *m_graph->getGraphManager().getGraphStorage();
     for (NodeIndex_t i = 0; i < n; ++i) {
-        m_graph->getGraphManager().getGraphStorage()->forEachOutgoingEdge(
-            i, [&](NodeIndex_t neighbour, CostType_t cost) {
-                m_sortedEdges.emplace_back(cost, i, neighbour);
-            });
+        forEachUniqueNeighbour(graphStorage, i, [&](NodeIndex_t neighbour, CostType_t cost) {
+            m_sortedEdges.emplace_back(cost, i, neighbour);
+        });
     }
 
     std::sort(m_sortedEdges.begin(), m_sortedEdges.end());
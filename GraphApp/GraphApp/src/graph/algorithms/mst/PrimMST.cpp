@@ -2,6 +2,8 @@
 
 #include "PrimMST.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
+
 PrimMST::PrimMST(Graph* graph) : ITimedAlgorithm(graph) {
     m_nodeInfo.resize(m_graph->getGraphManager().getNodesCount());
     m_nodeInfo[0].setCost(0);
@@ -41,18 +43,18 @@ bool PrimMST::step() {
         return true;
     }
 
-    m_graph->getGraphManager().getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-        m_currentNode, [&](NodeIndex_t neighbour, CostType_t cost) {
-            if (m_nodeInfo[neighbour].m_inMST) {
-                return;
-            }
+    const auto& graphStorage = *m_graph->getGraphManager().getGraphStorage();
+    forEachNeighbour(graphStorage, m_currentNode, [&](NodeIndex_t neighbour, CostType_t cost) {
+        if (m_nodeInfo[neighbour].m_inMST) {
+            return;
+        }
 
-            if (!m_nodeInfo[neighbour].m_minimalCostInitialized ||
-                cost < m_nodeInfo[neighbour].m_minimalCost) {
-                m_nodeInfo[neighbour].setCost(cost);
-                m_nodeInfo[neighbour].m_parent = m_currentNode;
-            }
-        });
+        if (!m_nodeInfo[neighbour].m_minimalCostInitialized ||
+            cost < m_nodeInfo[neighbour].m_minimalCost) {
+            m_nodeInfo[neighbour].setCost(cost);
+            m_nodeInfo[neighbour].m_parent = m_currentNode;
+        }
+    });
 
     setNodeState(m_currentNode, NodeData::State::VISITED);
     m_currentNode = INVALID_NODE;
@@ -2,6 +2,8 @@
 
 #include "Dijkstra.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
+
 Dijkstra::Dijkstra(Graph* graph) : ITimedAlgorithm(graph) {
     auto& graphManager = m_graph->getGraphManager();
 
@@ -81,18 +83,18 @@ bool Dijkstra::step() {
         return true;
     }
 
-    graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-        currentNode, [&](NodeIndex_t neighbour, CostType_t edgeCost) {
-            const int64_t newCost = currentCost + edgeCost;
+    const auto& graphStorage = *graphManager.getGraphStorage();
+    forEachNeighbour(graphStorage, currentNode, [&](NodeIndex_t neighbour, CostType_t edgeCost) {
+        const int64_t newCost = currentCost + edgeCost;
 
-            if (newCost < m_nodesInfo[neighbour].m_minCost) {
-                m_nodesInfo[neighbour].m_minCost = newCost;
-                m_nodesInfo[neighbour].m_parent = currentNode;
-                m_minHeap.emplace(newCost, neighbour);
+        if (newCost < m_nodesInfo[neighbour].m_minCost) {
+            m_nodesInfo[neighbour].m_minCost = newCost;
+            m_nodesInfo[neighbour].m_parent = currentNode;
+            m_minHeap.emplace(newCost, neighbour);
 
-                graphManager.addAlgorithmEdge(currentNode, neighbour, VISITED_PATH);
-            }
-        });
+            graphManager.addAlgorithmEdge(currentNode, neighbour, VISITED_PATH);
+        }
+    });
 
     setNodeState(currentNode, NodeData::State::VISITED);
     m_pseudocodeForm.highlight({12, 13, 14, 15, 16, 17});
@@ -2,6 +2,8 @@
 
 #include "FloydWarshall.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
+
 FloydWarshall::FloydWarshall(Graph* graph) : ITimedAlgorithm(graph) {
     auto& graphManager = graph->getGraphManager();
     const auto nodeCount = graphManager.getNodesCount();
@@ -10,11 +12,10 @@ FloydWarshall::FloydWarshall(Graph* graph) : ITimedAlgorithm(graph) {
     m_parentMatrix.resize(nodeCount * nodeCount, INVALID_NODE);
 
     for (NodeIndex_t i = 0; i < nodeCount; ++i) {
-        graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-            i, [&](NodeIndex_t j, CostType_t cost) {
-                m_distanceMatrix[i * nodeCount + j] = cost;
-                m_parentMatrix[i * nodeCount + j] = i;
-            });
+        forEachNeighbour(*graphManager.getGraphStorage(), i, [&](NodeIndex_t j, CostType_t cost) {
+            m_distanceMatrix[i * nodeCount + j] = cost;
+            m_parentMatrix[i * nodeCount + j] = i;
+        });
 
         m_distanceMatrix[i * nodeCount + i] = 0;
         m_parentMatrix[i * nodeCount + i] = INVALID_NODE;
@@ -162,8 +163,8 @@ void FloydWarshall::updateAlgorithmInfoText() const {
 void FloydWarshall::resetForUndo() {
     const auto nodeCount = m_graph->getGraphManager().getNodesCount();
     for (NodeIndex_t i = 0; i < nodeCount; ++i) {
-        m_graph->getGraphManager().getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-            i, [&](NodeIndex_t j, CostType_t cost) {
+        forEachNeighbour(
+            *m_graph->getGraphManager().getGraphStorage(), i, [&](NodeIndex_t j, CostType_t cost) {
                 m_distanceMatrix[i * nodeCount + j] = cost;
                 m_parentMatrix[i * nodeCount + j] = i;
             });
@@ -2,6 +2,8 @@
 
 #include "BreadthFirstTraversal.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
+
 BreadthFirstTraversal::BreadthFirstTraversal(Graph* graph) : ITimedAlgorithm(graph) {
     auto& graphManager = graph->getGraphManager();
     const auto nodeCount = graphManager.getNodesCount();
@@ -21,6 +23,12 @@ void BreadthFirstTraversal::start(NodeIndex_t startNode) {
 }
 
 bool BreadthFirstTraversal::step() {
+    if (m_stepDelay == 0 && getNodeState(m_startNode) == NodeData::State::UNVISITED &&
+        m_graph->getGraphManager().getGraphStorage()->type() == IGraphStorage::Type::BIT_MATRIX) {
+        runBitParallel();
+        return false;
+    }
+
     if (m_traversalContainer.empty()) {
         return false;
     }
@@ -36,8 +44,8 @@ bool BreadthFirstTraversal::step() {
     }
 
     bool addedNewNode = false;
-    graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-        currentNode, [&](NodeIndex_t neighbour, CostType_t) {
+    forEachNeighbour(
+        *graphManager.getGraphStorage(), currentNode, [&](NodeIndex_t neighbour, CostType_t) {
             const auto neighbourState = getNodeState(neighbour);
             if (neighbourState == NodeData::State::UNVISITED) {
                 setNodeState(neighbour, NodeData::State::VISITED);
@@ -61,8 +69,8 @@ bool BreadthFirstTraversal::step() {
     setNodeState(currentNode, NodeData::State::ANALYZED);
     m_pseudocodeForm.highlight({14});
 
-    graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-        currentNode, [&](NodeIndex_t neighbour, CostType_t) {
+    forEachNeighbour(
+        *graphManager.getGraphStorage(), currentNode, [&](NodeIndex_t neighbour, CostType_t) {
             if (getNodeState(neighbour) != NodeData::State::UNVISITED) {
                 graphManager.addAlgorithmEdge(currentNode, neighbour, ANALYZED_EDGE);
             }
@@ -102,6 +110,31 @@ void BreadthFirstTraversal::setStartNode(NodeIndex_t startNode) {
     m_nodesInfo[startNode].m_length = 0;
 }
 
+void BreadthFirstTraversal::runBitParallel() {
+    auto& graphManager = m_graph->getGraphManager();
+    const auto& bitMatrix = static_cast<const BitMatrix&>(*graphManager.getGraphStorage());
+
+    std::vector<NodeIndex_t> parents;
+    std::vector<uint32_t> levels;
+    bitMatrix.breadthFirstSearch(m_startNode, parents, levels);
+
+    for (NodeIndex_t node = 0; node < m_nodesInfo.size(); ++node) {
+        if (levels[node] == std::numeric_limits<uint32_t>::max()) {
+            continue;
+        }
+
+        m_nodesInfo[node].m_parentNode = parents[node];
+        m_nodesInfo[node].m_length = levels[node];
+        setNodeState(node, NodeData::State::ANALYZED);
+
+        if (parents[node] != INVALID_NODE) {
+            graphManager.addAlgorithmEdge(parents[node], node, ANALYZED_EDGE);
+        }
+    }
+
+    m_traversalContainer.clear();
+}
+
 void BreadthFirstTraversal::onFinishedAlgorithm() {
     auto& graphManager = m_graph->getGraphManager();
     graphManager.clearAlgorithmPath(ANALYZING_EDGE);
@@ -14,6 +14,7 @@ class BreadthFirstTraversal : public ITimedAlgorithm {
 
    protected:
     void setStartNode(NodeIndex_t startNode);
+    void runBitParallel();
     void onFinishedAlgorithm() override;
     void updateAlgorithmInfoText() const override;
     void resetForUndo() override;
@@ -2,6 +2,8 @@
 
 #include "DepthFirstTraversal.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
+
 DepthFirstTraversal::DepthFirstTraversal(Graph* graph) : ITimedAlgorithm(graph) {
     auto& graphManager = graph->getGraphManager();
     const auto nodeCount = graphManager.getNodesCount();
@@ -36,33 +38,32 @@ bool DepthFirstTraversal::step() {
     }
 
     bool addedNewNode = false;
-    graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-        currentNode, [&](NodeIndex_t neighbour, CostType_t) {
-            if (addedNewNode) {
-                return;
-            }
-
-            const auto neighbourState = getNodeState(neighbour);
-            if (neighbourState == NodeData::State::UNVISITED) {
-                setNodeState(neighbour, NodeData::State::VISITED);
+    forEachTraversedNeighbour(currentNode, [&](NodeIndex_t neighbour, CostType_t) {
+        if (addedNewNode) {
+            return;
+        }
 
-                graphManager.addAlgorithmEdge(currentNode, neighbour, VISITED_EDGE);
+        const auto neighbourState = getNodeState(neighbour);
+        if (neighbourState == NodeData::State::UNVISITED) {
+            setNodeState(neighbour, NodeData::State::VISITED);
 
-                m_nodesInfo[neighbour].m_parentNode = currentNode;
-                m_nodesInfo[neighbour].m_discoveryTime = ++m_currentTime;
-                m_traversalContainer.push_back(neighbour);
-                m_treeEdges.emplace_back(currentNode, neighbour);
+            addTraversedEdge(currentNode, neighbour, VISITED_EDGE);
 
-                if (m_isTotalTraversal) {
-                    m_pseudocodeForm.highlight({13, 14});
-                } else {
-                    m_pseudocodeForm.highlight({11, 12});
-                }
+            m_nodesInfo[neighbour].m_parentNode = currentNode;
+            m_nodesInfo[neighbour].m_discoveryTime = ++m_currentTime;
+            m_traversalContainer.push_back(neighbour);
+            m_treeEdges.emplace_back(currentNode, neighbour);
 
-                emit visitedNode(neighbour);
-                addedNewNode = true;
+            if (m_isTotalTraversal) {
+                m_pseudocodeForm.highlight({13, 14});
+            } else {
+                m_pseudocodeForm.highlight({11, 12});
             }
-        });
+
+            emit visitedNode(neighbour);
+            addedNewNode = true;
+        }
+    });
 
     if (!addedNewNode) {
         setNodeState(currentNode, NodeData::State::ANALYZED);
@@ -220,35 +221,53 @@ void DepthFirstTraversal::resetForUndo() {
 }
 
 void DepthFirstTraversal::updateEdgeClassification(NodeIndex_t node) {
-    m_graph->getGraphManager().getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-        node, [&](NodeIndex_t neighbour, CostType_t) {
-            if (getNodeState(neighbour) == NodeData::State::UNVISITED) {
-                return;
-            }
+    forEachTraversedNeighbour(node, [&](NodeIndex_t neighbour, CostType_t) {
+        if (getNodeState(neighbour) == NodeData::State::UNVISITED) {
+            return;
+        }
 
-            m_graph->getGraphManager().addAlgorithmEdge(node, neighbour, ANALYZED_EDGE);
+        addTraversedEdge(node, neighbour, ANALYZED_EDGE);
 
-            if (node == neighbour) {
-                m_backEdges.emplace_back(node, node);
-                return;
-            }
+        if (node == neighbour) {
+            m_backEdges.emplace_back(node, node);
+            return;
+        }
 
-            if (m_nodesInfo[neighbour].m_parentNode == node) {
-                return;
-            }
+        if (m_nodesInfo[neighbour].m_parentNode == node) {
+            return;
+        }
 
-            const auto t1X = m_nodesInfo[node].m_discoveryTime;
-            const auto t2X = m_nodesInfo[node].m_analyzeTime;
+        const auto t1X = m_nodesInfo[node].m_discoveryTime;
+        const auto t2X = m_nodesInfo[node].m_analyzeTime;
 
-            const auto t1Y = m_nodesInfo[neighbour].m_discoveryTime;
-            const auto t2Y = m_nodesInfo[neighbour].m_analyzeTime;
+        const auto t1Y = m_nodesInfo[neighbour].m_discoveryTime;
+        const auto t2Y = m_nodesInfo[neighbour].m_analyzeTime;
 
-            if (t1X < t1Y && t1Y < t2Y && t2Y < t2X) {
-                m_forwardEdges.emplace_back(node, neighbour);
-            } else if (t1Y < t1X && t1X < t2X && t2X < t2Y) {
-                m_backEdges.emplace_back(node, neighbour);
-            } else if (t1Y < t2Y && t2Y < t1X && t1X < t2X) {
-                m_crossEdges.emplace_back(node, neighbour);
-            }
-        });
+        if (t1X < t1Y && t1Y < t2Y && t2Y < t2X) {
+            m_forwardEdges.emplace_back(node, neighbour);
+        } else if (t1Y < t1X && t1X < t2X && t2X < t2Y) {
+            m_backEdges.emplace_back(node, neighbour);
+        } else if (t1Y < t2Y && t2Y < t1X && t1X < t2X) {
+            m_crossEdges.emplace_back(node, neighbour);
+        }
+    });
+}
+
+template <typename Callback>
+void DepthFirstTraversal::forEachTraversedNeighbour(NodeIndex_t node, Callback&& callback) const {
+    const auto& graphStorage = *m_graph->getGraphManager().getGraphStorage();
+    if (m_followIncomingEdges) {
+        forEachIncomingNeighbour(graphStorage, node, callback);
+    } else {
+        forEachNeighbour(graphStorage, node, callback);
+    }
+}
+
+void DepthFirstTraversal::addTraversedEdge(NodeIndex_t from, NodeIndex_t to,
+                                           size_t priority) const {
+    if (m_followIncomingEdges) {
+        m_graph->getGraphManager().addAlgorithmEdge(to, from, priority);
+    } else {
+        m_graph->getGraphManager().addAlgorithmEdge(from, to, priority);
+    }
 }
@@ -22,6 +22,10 @@ class DepthFirstTraversal : public ITimedAlgorithm {
 
     void updateEdgeClassification(NodeIndex_t node);
 
+    template <typename Callback>
+    void forEachTraversedNeighbour(NodeIndex_t node, Callback&& callback) const;
+    void addTraversedEdge(NodeIndex_t from, NodeIndex_t to, size_t priority) const;
+
     struct DFSInfo {
         NodeIndex_t m_parentNode{INVALID_NODE};
         uint32_t m_discoveryTime{MAX_TIME};
@@ -35,6 +39,9 @@ class DepthFirstTraversal : public ITimedAlgorithm {
     NodeIndex_t m_startNode{INVALID_NODE};
     bool m_isTotalTraversal{false};
 
+    // Walks the transposed graph through the incoming edges, without copying it.
+    bool m_followIncomingEdges{false};
+
     std::vector<std::pair<NodeIndex_t, NodeIndex_t>> m_treeEdges;
     std::vector<std::pair<NodeIndex_t, NodeIndex_t>> m_forwardEdges;
     std::vector<std::pair<NodeIndex_t, NodeIndex_t>> m_backEdges;
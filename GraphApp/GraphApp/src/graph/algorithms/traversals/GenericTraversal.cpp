@@ -2,6 +2,7 @@
 
 #include "GenericTraversal.h"
 
+#include "../graph/storage/GraphStorageVisitor.h"
 #include "../random/Random.h"
 
 GenericTraversal::GenericTraversal(Graph* graph) : ITimedAlgorithm(graph) {
@@ -52,8 +53,8 @@ bool GenericTraversal::step() {
     }
 
     bool addedNewNode = false;
-    graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-        m_currentNode, [&](NodeIndex_t neighbour, CostType_t) {
+    forEachNeighbour(
+        *graphManager.getGraphStorage(), m_currentNode, [&](NodeIndex_t neighbour, CostType_t) {
             if (addedNewNode) {
                 return;
             }
@@ -83,8 +84,8 @@ bool GenericTraversal::step() {
         setNodeState(m_currentNode, NodeData::State::ANALYZED);
         m_pseudocodeForm.highlight({m_isTotalTraversal ? 15 : 13});
 
-        graphManager.getGraphStorage()->forEachOutgoingEdgeWithOpposites(
-            m_currentNode, [&](NodeIndex_t neighbour, CostType_t) {
+        forEachNeighbour(
+            *graphManager.getGraphStorage(), m_currentNode, [&](NodeIndex_t neighbour, CostType_t) {
                 if (getNodeState(neighbour) != NodeData::State::UNVISITED) {
                     graphManager.addAlgorithmEdge(m_currentNode, neighbour, ANALYZED_EDGE);
                 }
@@ -3,6 +3,7 @@
 #include "PBFLoader.h"
 
 #include "../form/pbf_loader/PbfLoadSettings.h"
+#include "PointMerging.h"
 
 PBFLoader::PBFLoader(GraphManager* graphManager, const QString& pbfFile)
     : m_graphManager(graphManager) {
@@ -197,42 +198,47 @@ void PBFLoader::parseAndComputeBounds() {
 }
 
 void PBFLoader::addNodesToGraph() {
-    std::chrono::steady_clock::time_point lastUpdate = std::chrono::steady_clock::now();
-
-    for (const auto& [points, _] : m_ways) {
-        for (const auto loc : points) {
-            const auto mercatorPosCoord = m_projection(loc);
-            const QPointF mercatorPos{mercatorPosCoord.x, mercatorPosCoord.y};
-
-            const auto screenPos = mercatorToGraphPosition(mercatorPos);
-            if (m_screenToNodes.contains(screenPos)) {
-                continue;
-            }
+    std::vector<size_t> wayBegins(m_ways.size() + 1, 0);
+    for (size_t i = 0; i < m_ways.size(); ++i) {
+        wayBegins[i + 1] = wayBegins[i] + m_ways[i].m_locations.size();
+    }
 
-            if (m_accuracy > 0.f) {
-                const auto nearestNode = m_graphManager->getNode(screenPos, m_accuracy);
-                if (nearestNode.has_value()) {
-                    m_screenToNodes.emplace(screenPos, nearestNode.value());
-                    continue;
-                }
-            }
+    m_loadingScreen->setText(QString("Projecting %1 points").arg(wayBegins.back()));
 
-            if (!m_graphManager->addNode(screenPos)) {
-                throw std::runtime_error(
-                    "Failed to add node to the graph.\nNode is out of bounds!");
-            }
+    std::vector<QPoint> points(wayBegins.back());
+    const auto wayIndices = std::views::iota(size_t{0}, m_ways.size());
+    std::for_each(std::execution::par, wayIndices.begin(), wayIndices.end(), [&](size_t way) {
+        const auto& locations = m_ways[way].m_locations;
+        for (size_t i = 0; i < locations.size(); ++i) {
+            const auto mercatorPosCoord = m_projection(locations[i]);
+            const QPointF mercatorPos{mercatorPosCoord.x, mercatorPosCoord.y};
 
-            m_screenToNodes.emplace(screenPos, m_graphManager->getNodesCount() - 1);
+            points[wayBegins[way] + i] = mercatorToGraphPosition(mercatorPos);
         }
-
-        const auto now = std::chrono::steady_clock::now();
-        const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - lastUpdate);
-        if (elapsed.count() >= 2) {
-            lastUpdate = now;
-            m_loadingScreen->setText(
-                QString("Added %1 nodes").arg(m_graphManager->getNodesCount()));
+    });
+
+    m_loadingScreen->setText(QString("Merging %1 points").arg(points.size()));
+    const auto leaders = mergeNearbyPoints(points, m_accuracy);
+
+    // Leaders come before the points merged into them, so one pass numbers the
+    // nodes in file order.
+    std::vector<QPoint> positions;
+    m_locationNodes.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (leaders[i] == i) {
+            m_locationNodes[i] = static_cast<NodeIndex_t>(positions.size());
+            positions.push_back(points[i]);
+        } else {
+            m_locationNodes[i] = m_locationNodes[leaders[i]];
         }
     }
+
+    m_loadingScreen->setText(QString("Adding %1 nodes").arg(positions.size()));
+    m_graphManager->addNodes(positions);
+
+    if (m_graphManager->getNodesCount() != positions.size()) {
+        throw std::runtime_error("Failed to add node to the graph.\nNode is out of bounds!");
+    }
 }
 
 void PBFLoader::connectNodes() {
@@ -241,20 +247,15 @@ void PBFLoader::connectNodes() {
 
     m_graphManager->resizeAdjacencyMatrix(m_graphManager->getNodesCount());
 
+    std::vector<IGraphStorage::Edge_t> edges;
+    size_t location{};
     for (const auto& [points, oneWay] : m_ways) {
         NodeIndex_t prevNodeIndex = INVALID_NODE;
         osmium::Location prevLocation;
         int64_t distance{};
 
         for (const auto loc : points) {
-            const auto mercatorPosCoord = m_projection(loc);
-            const QPointF mercatorPos{mercatorPosCoord.x, mercatorPosCoord.y};
-
-            const auto screenPos = mercatorToGraphPosition(mercatorPos);
-            const auto nodeIndex = m_screenToNodes.value(screenPos, INVALID_NODE);
-            if (nodeIndex == INVALID_NODE) {
-                throw std::runtime_error("Failed to find node for way connection.");
-            }
+            const auto nodeIndex = m_locationNodes[location++];
 
             if (prevNodeIndex == INVALID_NODE) {
                 prevNodeIndex = nodeIndex;
@@ -271,9 +272,11 @@ void PBFLoader::connectNodes() {
                 continue;
             }
 
-            m_graphManager->addEdge(prevNodeIndex, nodeIndex, distance);
+            const auto cost = static_cast<CostType_t>(
+                std::min<int64_t>(distance, std::numeric_limits<CostType_t>::max()));
+            edges.push_back({prevNodeIndex, nodeIndex, cost});
             if (!oneWay) {
-                m_graphManager->addEdge(nodeIndex, prevNodeIndex, distance);
+                edges.push_back({nodeIndex, prevNodeIndex, cost});
             }
 
             prevNodeIndex = nodeIndex;
@@ -291,7 +294,15 @@ void PBFLoader::connectNodes() {
         }
     }
 
+    m_loadingScreen->setText(QString("Sorting %1 edges").arg(edges.size()));
+    m_graphManager->addEdges(edges);
+
+    // Ways are added in file order, so neighbouring nodes end up far apart in memory.
+    m_loadingScreen->setText("Reordering nodes");
+    m_graphManager->reorderNodes(GraphManager::NodeOrder::HILBERT_CURVE);
+
     m_loadingScreen->close();
+    m_graphManager->freezeGraphStorage();
     m_graphManager->buildEdgeCache();
 }
 
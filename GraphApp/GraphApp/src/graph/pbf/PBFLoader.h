@@ -30,7 +30,8 @@ class PBFLoader {
     std::string m_pbfPath;
 
     std::vector<WayData> m_ways{};
-    QHash<QPoint, NodeIndex_t> m_screenToNodes{};
+    // Node of every way location, the ways' locations laid end to end.
+    std::vector<NodeIndex_t> m_locationNodes{};
 
     qreal m_minX{std::numeric_limits<qreal>::max()};
     qreal m_maxX{std::numeric_limits<qreal>::min()};
@@ -0,0 +1,125 @@
+#include <pch.h>
+
+#include "PointMerging.h"
+
+static int32_t getCell(int coordinate, int cellSize) {
+    return coordinate >= 0 ? coordinate / cellSize : (coordinate + 1) / cellSize - 1;
+}
+
+// Flipping the sign bits keeps the keys in (x, y) order across negative coordinates.
+static uint64_t getCellKey(int32_t x, int32_t y) {
+    const auto orderedX = static_cast<uint32_t>(x) ^ 0x80000000u;
+    const auto orderedY = static_cast<uint32_t>(y) ^ 0x80000000u;
+    return uint64_t{orderedX} << 32 | orderedY;
+}
+
+static int32_t getCellKeyX(uint64_t key) {
+    return static_cast<int32_t>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
+}
+
+static int32_t getCellKeyY(uint64_t key) {
+    return static_cast<int32_t>(static_cast<uint32_t>(key) ^ 0x80000000u);
+}
+
+std::vector<uint32_t> mergeNearbyPoints(std::span<const QPoint> points, float mergeDistance) {
+    const auto cellSize = std::max(static_cast<int>(std::ceil(mergeDistance)), 1);
+    const auto mergeDistanceSquared = mergeDistance * mergeDistance;
+
+    // Sorting by (cell, point) groups the points of every cell.
+    std::vector<std::pair<uint64_t, uint32_t>> cells(points.size());
+    const auto indices = std::views::iota(uint32_t{0}, static_cast<uint32_t>(points.size()));
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](uint32_t i) {
+        const auto x = getCell(points[i].x(), cellSize);
+        const auto y = getCell(points[i].y(), cellSize);
+
+        cells[i] = {getCellKey(x, y), i};
+    });
+
+    std::sort(std::execution::par, cells.begin(), cells.end());
+
+    std::vector<uint64_t> cellKeys;
+    std::vector<uint32_t> pointCells(points.size());
+    for (const auto& [key, point] : cells) {
+        if (cellKeys.empty() || cellKeys.back() != key) {
+            cellKeys.push_back(key);
+        }
+
+        pointCells[point] = static_cast<uint32_t>(cellKeys.size() - 1);
+    }
+
+    // The three cells of a neighbouring column are consecutive keys, so every cell keeps one
+    // [begin, end) run per column. The runs only move forward as the cells do.
+    struct CellColumns_t {
+        std::array<uint32_t, 3> m_begins;
+        std::array<uint32_t, 3> m_ends;
+    };
+    std::vector<CellColumns_t> neighbourColumns(cellKeys.size());
+
+    for (int32_t column = 0; column < 3; ++column) {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        for (uint32_t cell = 0; cell < cellKeys.size(); ++cell) {
+            const auto x = getCellKeyX(cellKeys[cell]);
+            const auto y = getCellKeyY(cellKeys[cell]);
+
+            const auto first = getCellKey(x + column - 1, y - 1);
+            const auto last = getCellKey(x + column - 1, y + 1);
+            while (begin < cellKeys.size() && cellKeys[begin] < first) {
+                ++begin;
+            }
+            end = std::max(end, begin);
+            while (end < cellKeys.size() && cellKeys[end] <= last) {
+                ++end;
+            }
+
+            neighbourColumns[cell].m_begins[column] = begin;
+            neighbourColumns[cell].m_ends[column] = end;
+        }
+    }
+
+    // Leaders are mergeDistance apart and a cell is narrower than that, so each
+    // quarter of a cell holds at most one of them.
+    struct CellLeaders_t {
+        std::array<uint32_t, 4> m_leaders;
+        uint32_t m_count{0};
+    };
+    std::vector<CellLeaders_t> cellLeaders(cellKeys.size());
+
+    std::vector<uint32_t> leaders(points.size());
+    for (uint32_t point = 0; point < points.size(); ++point) {
+        auto leader = point;
+        auto leaderDistanceSquared = std::numeric_limits<int64_t>::max();
+
+        const auto& [columnBegins, columnEnds] = neighbourColumns[pointCells[point]];
+        for (size_t column = 0; column < 3; ++column) {
+            for (auto cell = columnBegins[column]; cell < columnEnds[column]; ++cell) {
+                const auto& [cellLeaderPoints, cellLeaderCount] = cellLeaders[cell];
+                for (uint32_t i = 0; i < cellLeaderCount; ++i) {
+                    const auto cellLeader = cellLeaderPoints[i];
+                    const int64_t dx = points[cellLeader].x() - points[point].x();
+                    const int64_t dy = points[cellLeader].y() - points[point].y();
+                    const auto distanceSquared = dx * dx + dy * dy;
+
+                    const auto closeEnough =
+                        distanceSquared == 0 || distanceSquared < mergeDistanceSquared;
+                    const auto closer =
+                        distanceSquared < leaderDistanceSquared ||
+                        (distanceSquared == leaderDistanceSquared && cellLeader < leader);
+                    if (closeEnough && closer) {
+                        leader = cellLeader;
+                        leaderDistanceSquared = distanceSquared;
+                    }
+                }
+            }
+        }
+
+        if (leader == point) {
+            auto& [cellLeaderPoints, cellLeaderCount] = cellLeaders[pointCells[point]];
+            cellLeaderPoints[cellLeaderCount++] = point;
+        }
+
+        leaders[point] = leader;
+    }
+
+    return leaders;
+}
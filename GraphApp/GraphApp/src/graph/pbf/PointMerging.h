@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * Merges points closer than mergeDistance, over a uniform grid of cells that
+ * are mergeDistance wide (at least one unit, so equal points always merge).
+ *
+ * Points are resolved in order: a point joins the nearest earlier leader closer
+ * than mergeDistance, the earlier one on ties, or becomes a leader itself. Such
+ * a leader can only lie in the point's cell or in one of the eight around it,
+ * so only those are searched, whichever side of a cell border the points are.
+ *
+ * Bucketing the points runs in parallel and the neighbours of every cell are
+ * found in one linear sweep over the sorted cells; the resolving pass is
+ * sequential, since every point depends on the leaders chosen before it.
+ *
+ * Returns the leader of every point. A leader is its own leader and always
+ * comes before the points that joined it.
+ */
+std::vector<uint32_t> mergeNearbyPoints(std::span<const QPoint> points, float mergeDistance);
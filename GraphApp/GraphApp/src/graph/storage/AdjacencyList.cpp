@@ -2,81 +2,169 @@
 
 #include "AdjacencyList.h"
 
-IGraphStorage::Type AdjacencyList::type() const { return Type::ADJACENCY_LIST; }
+template <typename StoredCost_t>
+IGraphStorage::Type AdjacencyList<StoredCost_t>::type() const {
+    return Type::ADJACENCY_LIST;
+}
 
-void AdjacencyList::resize(size_t nodeCount) { m_adjacencyList.resize(nodeCount); }
+template <typename StoredCost_t>
+IGraphStorage::CostWidth AdjacencyList<StoredCost_t>::costWidth() const {
+    return costWidthOf<StoredCost_t>();
+}
 
-void AdjacencyList::addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) {
-    auto& neighbours = m_adjacencyList[start];
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::resize(size_t nodeCount) {
+    m_incomingEdges.clear();
+    m_adjacencyList.resize(nodeCount);
+}
 
-    if (!neighbours.empty() && neighbours.back().first < end) {
-        neighbours.emplace_back(end, cost);
-        return;
-    }
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) {
+    m_incomingEdges.clear();
 
-    auto it = std::lower_bound(
-        neighbours.begin(), neighbours.end(), end,
-        [](const auto& neighbour, NodeIndex_t value) { return neighbour.first < value; });
+    const auto neighbours = m_adjacencyList[start];
+
+    auto it = neighbours.end();
+    if (!neighbours.empty() && neighbours.back().m_index >= end) {
+        it = std::lower_bound(
+            neighbours.begin(), neighbours.end(), end,
+            [](const auto& neighbour, NodeIndex_t value) { return neighbour.m_index < value; });
 
-    if (it != neighbours.end() && it->first == end) {
-        it->second = cost;
-        return;
+        if (it->m_index == end) {
+            it->m_cost = static_cast<StoredCost_t>(cost);
+            return;
+        }
     }
 
-    neighbours.insert(it, std::make_pair(end, cost));
+    const bool hasOpposite = start == end || getEdge(end, start).has_value();
+    m_adjacencyList.insert(start, it - neighbours.begin(),
+                           Neighbour_t{end, hasOpposite, static_cast<StoredCost_t>(cost)});
+
+    if (hasOpposite && start != end) {
+        setHasOpposite(end, start, true);
+    }
 }
 
-void AdjacencyList::removeEdge(NodeIndex_t start, NodeIndex_t end) {
-    auto& neighbours = m_adjacencyList[start];
-    auto it = getNeighbour(start, end);
-    if (it == neighbours.end()) {
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::removeEdge(NodeIndex_t start, NodeIndex_t end) {
+    m_incomingEdges.clear();
+
+    const auto it = getNeighbour(start, end);
+    if (!it) {
         throw std::runtime_error{"Tried removing an edge that doesn't exist!"};
     }
 
-    neighbours.erase(it);
+    const bool hadOpposite = it->m_hasOpposite;
+    m_adjacencyList.erase(start, it - m_adjacencyList[start].data());
+
+    if (hadOpposite && start != end) {
+        setHasOpposite(end, start, false);
+    }
+}
+
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::addEdges(std::span<const Edge_t> edges) {
+    m_incomingEdges.clear();
+
+    // Counting sort by source keeps the input order inside every bucket, so a later
+    // duplicate overrides an earlier one just like with repeated addEdge calls.
+    std::vector<size_t> offsets(m_adjacencyList.size() + 1, 0);
+    for (const auto& edge : edges) {
+        ++offsets[edge.m_start + 1];
+    }
+    std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<Neighbour_t> buckets(edges.size());
+    auto cursors = offsets;
+    for (const auto& [start, end, cost] : edges) {
+        buckets[cursors[start]++] = Neighbour_t{end, false, static_cast<StoredCost_t>(cost)};
+    }
+
+    // Every row gets room for its whole bucket up front, so the rows below can be
+    // filled in parallel without allocating from the arena.
+    std::vector<uint32_t> capacities(m_adjacencyList.size());
+    for (size_t node = 0; node < m_adjacencyList.size(); ++node) {
+        capacities[node] = static_cast<uint32_t>(m_adjacencyList[node].size() + offsets[node + 1] -
+                                                 offsets[node]);
+    }
+    m_adjacencyList.repack(capacities);
+
+    const auto indices =
+        std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(m_adjacencyList.size()));
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t node) {
+        if (offsets[node] == offsets[node + 1]) {
+            return;
+        }
+
+        const auto oldSize = m_adjacencyList[node].size();
+        m_adjacencyList.resizeRow(node, capacities[node]);
+
+        const auto neighbours = m_adjacencyList[node];
+        std::copy(buckets.begin() + offsets[node], buckets.begin() + offsets[node + 1],
+                  neighbours.begin() + oldSize);
+        std::ranges::stable_sort(neighbours, {}, [](const Neighbour_t& neighbour) {
+            return static_cast<NodeIndex_t>(neighbour.m_index);
+        });
+
+        // Keep the last entry of every run of equal targets.
+        auto last = neighbours.begin();
+        for (auto it = std::next(last); it != neighbours.end(); ++it) {
+            if (it->m_index != last->m_index) {
+                ++last;
+            }
+            *last = *it;
+        }
+        m_adjacencyList.resizeRow(node,
+                                  static_cast<uint32_t>(std::next(last) - neighbours.begin()));
+    });
+
+    recomputeOppositeFlags();
 }
 
-std::optional<CostType_t> AdjacencyList::getEdge(NodeIndex_t start, NodeIndex_t end) const {
+template <typename StoredCost_t>
+std::optional<CostType_t> AdjacencyList<StoredCost_t>::getEdge(NodeIndex_t start,
+                                                              NodeIndex_t end) const {
     if (start >= m_adjacencyList.size()) {
         return std::nullopt;
     }
 
     const auto it = getNeighbour(start, end);
-    if (it == m_adjacencyList[start].end()) {
+    if (!it) {
         return std::nullopt;
     }
 
-    return it->second;
+    return it->m_cost;
 }
 
-void AdjacencyList::forEachOutgoingEdge(
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::forEachOutgoingEdge(
     NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
-    if (node >= m_adjacencyList.size()) {
-        return;
-    }
-
-    for (const auto& [neighbour, cost] : m_adjacencyList[node]) {
-        if (node >= neighbour && getEdge(neighbour, node)) {
-            continue;
-        }
-
+    for (const auto [neighbour, cost] : uniqueNeighbours(node)) {
         callback(neighbour, cost);
     }
 }
 
-void AdjacencyList::forEachOutgoingEdgeWithOpposites(
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::forEachOutgoingEdgeWithOpposites(
     NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
-    if (node >= m_adjacencyList.size()) {
-        return;
+    for (const auto [neighbour, cost] : neighbours(node)) {
+        callback(neighbour, cost);
     }
+}
 
-    for (const auto& [neighbour, cost] : m_adjacencyList[node]) {
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::forEachIncomingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : incomingNeighbours(node)) {
         callback(neighbour, cost);
     }
 }
 
-void AdjacencyList::recomputeBeforeRemovingNodes(
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::recomputeBeforeRemovingNodes(
     size_t oldNodeCount, const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) {
+    m_incomingEdges.clear();
+
     std::vector<NodeIndex_t> indexRemap(oldNodeCount, INVALID_NODE);
     for (NodeIndex_t oldIndex = 0, newIndex = 0; oldIndex < oldNodeCount; ++oldIndex) {
         if (!selectedNodes.contains(oldIndex)) {
@@ -87,53 +175,119 @@ void AdjacencyList::recomputeBeforeRemovingNodes(
     AdjacencyList_t newAdjacencyList;
     newAdjacencyList.resize(oldNodeCount - selectedNodes.size());
 
+    std::vector<uint32_t> capacities(newAdjacencyList.size());
+    for (size_t start = 0; start < oldNodeCount; ++start) {
+        if (indexRemap[start] != INVALID_NODE) {
+            capacities[indexRemap[start]] = static_cast<uint32_t>(m_adjacencyList[start].size());
+        }
+    }
+    newAdjacencyList.repack(capacities);
+
     for (size_t start = 0; start < oldNodeCount; ++start) {
         NodeIndex_t newStart = indexRemap[start];
         if (newStart == INVALID_NODE) {
             continue;
         }
 
-        const auto& neighbours = m_adjacencyList[start];
-        Neighbours_t newNeighbours;
-        newNeighbours.reserve(neighbours.size());
+        newAdjacencyList.resizeRow(newStart, capacities[newStart]);
+        const auto newNeighbours = newAdjacencyList[newStart];
+        auto newNeighbour = newNeighbours.begin();
 
-        for (const auto& [end, cost] : neighbours) {
-            NodeIndex_t newEnd = indexRemap[end];
+        // Both directions of an edge survive or vanish together, so the opposite bits stay valid.
+        for (const auto& neighbour : m_adjacencyList[start]) {
+            NodeIndex_t newEnd = indexRemap[neighbour.m_index];
             if (newEnd != INVALID_NODE) {
-                newNeighbours.emplace_back(newEnd, cost);
+                *newNeighbour++ = {newEnd, neighbour.m_hasOpposite, neighbour.m_cost};
             }
         }
 
-        newAdjacencyList[newStart] = std::move(newNeighbours);
+        newAdjacencyList.resizeRow(newStart,
+                                   static_cast<uint32_t>(newNeighbour - newNeighbours.begin()));
     }
 
     m_adjacencyList = std::move(newAdjacencyList);
 }
 
-void AdjacencyList::recomputeAfterAddingNode(size_t newNodeCount) { resize(newNodeCount); }
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::recomputeAfterAddingNode(size_t newNodeCount) {
+    resize(newNodeCount);
+}
 
-AdjacencyList::Neighbours_t::iterator AdjacencyList::getNeighbour(NodeIndex_t start,
-                                                                  NodeIndex_t end) {
-    auto& neighbours = m_adjacencyList[start];
-    auto it = std::lower_bound(
-        neighbours.begin(), neighbours.end(), end,
-        [](const auto& neighbour, NodeIndex_t dest) { return neighbour.first < dest; });
-    if (it == neighbours.end() || it->first != end) {
-        return neighbours.end();
+template <typename StoredCost_t>
+std::span<const typename AdjacencyList<StoredCost_t>::Neighbour_t>
+AdjacencyList<StoredCost_t>::getNeighbours(NodeIndex_t node) const {
+    if (node >= m_adjacencyList.size()) {
+        return {};
+    }
+
+    return m_adjacencyList[node];
+}
+
+template <typename StoredCost_t>
+const IncomingEdgeIndex& AdjacencyList<StoredCost_t>::getIncomingEdges() const {
+    std::scoped_lock lock{m_incomingEdgesMutex};
+    if (!m_incomingEdges.isBuilt()) {
+        m_incomingEdges.build(*this, m_adjacencyList.size());
     }
 
-    return it;
+    return m_incomingEdges;
+}
+
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::setHasOpposite(NodeIndex_t start, NodeIndex_t end,
+                                                 bool hasOpposite) {
+    if (const auto it = getNeighbour(start, end)) {
+        it->m_hasOpposite = hasOpposite;
+    }
 }
 
-AdjacencyList::Neighbours_t::const_iterator AdjacencyList::getNeighbour(NodeIndex_t start,
-                                                                        NodeIndex_t end) const {
-    const auto& neighbours = m_adjacencyList[start];
+template <typename StoredCost_t>
+void AdjacencyList<StoredCost_t>::recomputeOppositeFlags() {
+    std::vector<size_t> offsets(m_adjacencyList.size() + 1, 0);
+    for (size_t node = 0; node < m_adjacencyList.size(); ++node) {
+        offsets[node + 1] = offsets[node] + m_adjacencyList[node].size();
+    }
+
+    // Flags are gathered first since they share a word with the m_index being searched.
+    std::vector<uint8_t> hasOpposite(offsets.back());
+
+    const auto indices =
+        std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(m_adjacencyList.size()));
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t node) {
+        auto* flags = hasOpposite.data() + offsets[node];
+        for (const auto& neighbour : m_adjacencyList[node]) {
+            *flags++ = neighbour.m_index == node || getEdge(neighbour.m_index, node).has_value();
+        }
+    });
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t node) {
+        const auto* flags = hasOpposite.data() + offsets[node];
+        for (auto& neighbour : m_adjacencyList[node]) {
+            neighbour.m_hasOpposite = *flags++;
+        }
+    });
+}
+
+template <typename StoredCost_t>
+typename AdjacencyList<StoredCost_t>::Neighbour_t* AdjacencyList<StoredCost_t>::getNeighbour(
+    NodeIndex_t start, NodeIndex_t end) {
+    return const_cast<Neighbour_t*>(std::as_const(*this).getNeighbour(start, end));
+}
+
+template <typename StoredCost_t>
+const typename AdjacencyList<StoredCost_t>::Neighbour_t* AdjacencyList<StoredCost_t>::getNeighbour(
+    NodeIndex_t start, NodeIndex_t end) const {
+    const auto neighbours = m_adjacencyList[start];
     auto it = std::lower_bound(
-        neighbours.cbegin(), neighbours.cend(), end,
-        [](const auto& neighbour, NodeIndex_t dest) { return neighbour.first < dest; });
-    if (it == neighbours.cend() || it->first != end) {
-        return neighbours.cend();
+        neighbours.begin(), neighbours.end(), end,
+        [](const auto& neighbour, NodeIndex_t dest) { return neighbour.m_index < dest; });
+    if (it == neighbours.end() || it->m_index != end) {
+        return nullptr;
     }
 
-    return it;
+    return &*it;
 }
+
+template class AdjacencyList<int8_t>;
+template class AdjacencyList<int16_t>;
+template class AdjacencyList<int32_t>;
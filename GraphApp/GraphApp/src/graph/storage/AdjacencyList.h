@@ -1,20 +1,55 @@
 #pragma once
 
 #include "IGraphStorage.h"
+#include "IncomingEdgeIndex.h"
+#include "NeighbourArena.h"
 
+/**
+ * @class AdjacencyList
+ * @brief Sorted per-node neighbour lists for sparse, mutable graphs.
+ *
+ * Every entry carries a "has opposite" bit that is kept in sync by addEdge and
+ * removeEdge, so undirected deduplication in uniqueNeighbours is a bit test
+ * instead of a binary search in the neighbour's list.
+ *
+ * Neighbour lists live in a NeighbourArena, so millions of low degree nodes
+ * share one buffer instead of owning a heap allocation each.
+ *
+ * StoredCost_t picks the cost width (int8_t, int16_t or int32_t). Entries are
+ * packed, so an int8_t list spends 5 bytes per edge instead of 8.
+ *
+ * Incoming edges come from an IncomingEdgeIndex built on the first query and
+ * dropped on every edit.
+ */
+template <typename StoredCost_t>
 class AdjacencyList final : public IGraphStorage {
+    static_assert(std::is_same_v<StoredCost_t, int8_t> || std::is_same_v<StoredCost_t, int16_t> ||
+                      std::is_same_v<StoredCost_t, int32_t>,
+                  "StoredCost_t must be int8_t, int16_t, or int32_t");
+
    public:
-    using Neighbour_t = std::pair<NodeIndex_t, CostType_t>;
-    using Neighbours_t = std::vector<Neighbour_t>;
-    using AdjacencyList_t = std::vector<Neighbours_t>;
+#pragma pack(push, 1)
+    struct Neighbour_t {
+        NodeIndex_t m_index : 31;
+        NodeIndex_t m_hasOpposite : 1;
+        StoredCost_t m_cost;
+    };
+#pragma pack(pop)
+    using AdjacencyList_t = NeighbourArena<Neighbour_t>;
+
+    static constexpr CostType_t MAX_COST = std::numeric_limits<StoredCost_t>::max();
+    static constexpr CostType_t MIN_COST = std::numeric_limits<StoredCost_t>::min();
 
     Type type() const override;
+    CostWidth costWidth() const override;
 
     void resize(size_t nodeCount) override;
 
     void addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) override;
     void removeEdge(NodeIndex_t start, NodeIndex_t end) override;
 
+    void addEdges(std::span<const Edge_t> edges) override;
+
     std::optional<CostType_t> getEdge(NodeIndex_t start, NodeIndex_t end) const override;
 
     void forEachOutgoingEdge(
@@ -23,15 +58,48 @@ class AdjacencyList final : public IGraphStorage {
     void forEachOutgoingEdgeWithOpposites(
         NodeIndex_t node,
         const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachIncomingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
 
     void recomputeBeforeRemovingNodes(
         size_t oldNodeCount,
         const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) override;
     void recomputeAfterAddingNode(size_t newNodeCount) override;
 
+    auto neighbours(NodeIndex_t node) const {
+        return getNeighbours(node) | std::views::transform([](const Neighbour_t& neighbour) {
+                   return std::make_pair(static_cast<NodeIndex_t>(neighbour.m_index),
+                                         static_cast<CostType_t>(neighbour.m_cost));
+               });
+    }
+
+    auto uniqueNeighbours(NodeIndex_t node) const {
+        return getNeighbours(node) | std::views::filter([node](const Neighbour_t& neighbour) {
+                   return !neighbour.m_hasOpposite || node < neighbour.m_index;
+               }) |
+               std::views::transform([](const Neighbour_t& neighbour) {
+                   return std::make_pair(static_cast<NodeIndex_t>(neighbour.m_index),
+                                         static_cast<CostType_t>(neighbour.m_cost));
+               });
+    }
+
+    auto incomingNeighbours(NodeIndex_t node) const {
+        return getIncomingEdges().neighbours(node);
+    }
+
    private:
-    Neighbours_t::iterator getNeighbour(NodeIndex_t start, NodeIndex_t end);
-    Neighbours_t::const_iterator getNeighbour(NodeIndex_t start, NodeIndex_t end) const;
+    std::span<const Neighbour_t> getNeighbours(NodeIndex_t node) const;
+    const IncomingEdgeIndex& getIncomingEdges() const;
+
+    void setHasOpposite(NodeIndex_t start, NodeIndex_t end, bool hasOpposite);
+    void recomputeOppositeFlags();
+
+    Neighbour_t* getNeighbour(NodeIndex_t start, NodeIndex_t end);
+    const Neighbour_t* getNeighbour(NodeIndex_t start, NodeIndex_t end) const;
 
     AdjacencyList_t m_adjacencyList;
+
+    mutable IncomingEdgeIndex m_incomingEdges;
+    mutable std::mutex m_incomingEdgesMutex;
 };
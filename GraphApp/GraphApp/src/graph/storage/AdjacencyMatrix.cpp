@@ -2,60 +2,81 @@
 
 #include "AdjacencyMatrix.h"
 
-IGraphStorage::Type AdjacencyMatrix::type() const { return Type::ADJACENCY_MATRIX; }
+template <typename StoredCost_t>
+IGraphStorage::Type AdjacencyMatrix<StoredCost_t>::type() const {
+    return Type::ADJACENCY_MATRIX;
+}
 
-void AdjacencyMatrix::resize(size_t nodeCount) {
-    m_nodeCount = nodeCount;
-    m_matrix.resize(nodeCount * nodeCount, 0);
+template <typename StoredCost_t>
+IGraphStorage::CostWidth AdjacencyMatrix<StoredCost_t>::costWidth() const {
+    return costWidthOf<StoredCost_t>();
 }
 
-void AdjacencyMatrix::addEdge(NodeIndex_t i, NodeIndex_t j, CostType_t cost) {
-    m_matrix[i * m_nodeCount + j] = encode(cost);
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::resize(size_t nodeCount) {
+    if (nodeCount == m_nodeCount) {
+        return;
+    }
+
+    if (nodeCount > m_nodeCount) {
+        return recomputeAfterAddingNode(nodeCount);
+    }
+
+    std::set<NodeIndex_t, std::greater<NodeIndex_t>> removedNodes;
+    for (auto node = static_cast<NodeIndex_t>(nodeCount); node < m_nodeCount; ++node) {
+        removedNodes.insert(node);
+    }
+
+    recomputeBeforeRemovingNodes(m_nodeCount, removedNodes);
 }
 
-void AdjacencyMatrix::removeEdge(NodeIndex_t i, NodeIndex_t j) {
-    m_matrix[i * m_nodeCount + j] = 0;
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::addEdge(NodeIndex_t i, NodeIndex_t j, CostType_t cost) {
+    m_matrix[i * m_capacity + j] = encode(cost);
 }
 
-std::optional<CostType_t> AdjacencyMatrix::getEdge(NodeIndex_t start, NodeIndex_t end) const {
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::removeEdge(NodeIndex_t i, NodeIndex_t j) {
+    m_matrix[i * m_capacity + j] = 0;
+}
+
+template <typename StoredCost_t>
+std::optional<CostType_t> AdjacencyMatrix<StoredCost_t>::getEdge(NodeIndex_t start,
+                                                                NodeIndex_t end) const {
     const auto raw = read(start, end);
     if (!(raw & FLAG_BIT)) {
         return std::nullopt;
     }
 
-    auto val = raw & COST_MASK;
-    if (val & (FLAG_BIT >> 1)) {
-        val |= ~COST_MASK;
-    }
-
-    return static_cast<CostType_t>(val);
+    return decode(raw);
 }
 
-void AdjacencyMatrix::forEachOutgoingEdge(
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::forEachOutgoingEdge(
     NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
-    for (NodeIndex_t i = 0; i < m_nodeCount; ++i) {
-        if (node >= i && getEdge(i, node)) {
-            continue;
-        }
+    for (const auto [i, cost] : uniqueNeighbours(node)) {
+        callback(i, cost);
+    }
+}
 
-        const auto edge = getEdge(node, i);
-        if (edge) {
-            callback(i, edge.value());
-        }
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::forEachOutgoingEdgeWithOpposites(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [i, cost] : neighbours(node)) {
+        callback(i, cost);
     }
 }
 
-void AdjacencyMatrix::forEachOutgoingEdgeWithOpposites(
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::forEachIncomingEdge(
     NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
-    for (NodeIndex_t i = 0; i < m_nodeCount; ++i) {
-        const auto edge = getEdge(node, i);
-        if (edge) {
-            callback(i, edge.value());
-        }
+    for (const auto [neighbour, cost] : incomingNeighbours(node)) {
+        callback(neighbour, cost);
     }
 }
 
-void AdjacencyMatrix::recomputeBeforeRemovingNodes(
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::recomputeBeforeRemovingNodes(
     size_t oldNodeCount, const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) {
     size_t newNodeCount = m_nodeCount - selectedNodes.size();
 
@@ -76,46 +97,74 @@ void AdjacencyMatrix::recomputeBeforeRemovingNodes(
             return;
         }
 
-        for (NodeIndex_t j = 0; j < m_nodeCount; ++j) {
+        for (const auto [j, cost] : neighbours(i)) {
             const auto new_j = indexRemap[j];
-
-            const auto edge = getEdge(i, j);
-            if (new_j == INVALID_NODE || !edge) {
+            if (new_j == INVALID_NODE) {
                 continue;
             }
 
-            newMatrix[new_i * newNodeCount + new_j] = encode(edge.value());
+            newMatrix[new_i * newNodeCount + new_j] = encode(cost);
         }
     });
 
     m_nodeCount = newNodeCount;
+    m_capacity = newNodeCount;
     m_matrix = std::move(newMatrix);
 }
 
-void AdjacencyMatrix::recomputeAfterAddingNode(size_t newNodeCount) {
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::recomputeAfterAddingNode(size_t newNodeCount) {
+    if (newNodeCount > m_capacity) {
+        reallocate(std::max(newNodeCount, m_capacity + m_capacity / 4));
+    }
+
+    m_nodeCount = newNodeCount;
+}
+
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::complete() {
+    for (size_t i = 0; i < m_nodeCount; ++i) {
+        std::fill_n(m_matrix.begin() + i * m_capacity, m_nodeCount, FLAG_BIT);
+    }
+}
+
+template <typename StoredCost_t>
+typename AdjacencyMatrix<StoredCost_t>::UnsignedCostType_t AdjacencyMatrix<StoredCost_t>::encode(
+    CostType_t cost) {
+    return static_cast<UnsignedCostType_t>(FLAG_BIT | (cost & COST_MASK));
+}
+
+template <typename StoredCost_t>
+CostType_t AdjacencyMatrix<StoredCost_t>::decode(UnsignedCostType_t raw) {
+    auto val = raw & COST_MASK;
+    if (val & (FLAG_BIT >> 1)) {
+        val |= ~COST_MASK;
+    }
+
+    return static_cast<CostType_t>(val);
+}
+
+template <typename StoredCost_t>
+typename AdjacencyMatrix<StoredCost_t>::UnsignedCostType_t AdjacencyMatrix<StoredCost_t>::read(
+    NodeIndex_t i, NodeIndex_t j) const {
+    return m_matrix[i * m_capacity + j];
+}
+
+template <typename StoredCost_t>
+void AdjacencyMatrix<StoredCost_t>::reallocate(size_t capacity) {
     std::vector<UnsignedCostType_t> newMatrix;
-    newMatrix.resize(newNodeCount * newNodeCount, 0);
+    newMatrix.resize(capacity * capacity, 0);
 
     const auto indices = std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(m_nodeCount));
     std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
-        for (NodeIndex_t j = 0; j < m_nodeCount; ++j) {
-            const auto edge = getEdge(i, j);
-            if (edge) {
-                newMatrix[i * newNodeCount + j] = encode(edge.value());
-            }
-        }
+        std::copy_n(m_matrix.begin() + i * m_capacity, m_nodeCount,
+                    newMatrix.begin() + i * capacity);
     });
 
-    m_nodeCount = newNodeCount;
+    m_capacity = capacity;
     m_matrix = std::move(newMatrix);
 }
 
-void AdjacencyMatrix::complete() { std::fill(m_matrix.begin(), m_matrix.end(), FLAG_BIT); }
-
-AdjacencyMatrix::UnsignedCostType_t AdjacencyMatrix::encode(CostType_t cost) {
-    return FLAG_BIT | (cost & COST_MASK);
-}
-
-AdjacencyMatrix::UnsignedCostType_t AdjacencyMatrix::read(NodeIndex_t i, NodeIndex_t j) const {
-    return m_matrix[i * m_nodeCount + j];
-}
+template class AdjacencyMatrix<int8_t>;
+template class AdjacencyMatrix<int16_t>;
+template class AdjacencyMatrix<int32_t>;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FlaggedLanes.h"
 #include "IGraphStorage.h"
 
 /**
@@ -11,6 +12,9 @@
  * - MSB (leftmost bit): Edge existence flag (1 = edge exists, 0 = no edge)
  * - Remaining N-1 bits: Edge cost stored as signed integer in two's complement
  *
+ * StoredCost_t picks the entry width (int8_t, int16_t or int32_t), so graphs
+ * with small costs pay 1 or 2 bytes per cell instead of 4.
+ *
  * Example with int16_t (16 bits total):
  * - MSB (leftmost bit): Edge flag
  * - Next 15 bits: Cost value (range: -16384 to 16383)
@@ -18,11 +22,28 @@
  * Binary representation: [Flag bit (MSB)][15-bit cost][LSB]
  *
  * This design allows querying edge existence and retrieving cost in a single
- * memory access, improving cache efficiency for graph algorithms.
+ * memory access, improving cache efficiency for graph algorithms. Since the
+ * flag is the sign bit, rows are scanned with FlaggedLanes and only the set
+ * entries get decoded.
+ *
+ * Rows are m_capacity entries apart and the capacity grows geometrically, so
+ * adding nodes one at a time costs amortized O(n) instead of an n^2 copy each.
+ * The side only grows by a quarter, since the memory grows with its square and
+ * evaluateStorageStrategy budgets for the node count, not for the capacity.
+ * Cells outside the m_nodeCount x m_nodeCount block are always zero.
  */
+template <typename StoredCost_t>
 class AdjacencyMatrix final : public IGraphStorage {
+    static_assert(std::is_same_v<StoredCost_t, int8_t> || std::is_same_v<StoredCost_t, int16_t> ||
+                      std::is_same_v<StoredCost_t, int32_t>,
+                  "StoredCost_t must be int8_t, int16_t, or int32_t");
+
    public:
+    static constexpr CostType_t MAX_COST = (CostType_t{1} << (sizeof(StoredCost_t) * 8 - 2)) - 1;
+    static constexpr CostType_t MIN_COST = -MAX_COST - 1;
+
     Type type() const override;
+    CostWidth costWidth() const override;
 
     void resize(size_t nodeCount) override;
 
@@ -37,6 +58,9 @@ class AdjacencyMatrix final : public IGraphStorage {
     void forEachOutgoingEdgeWithOpposites(
         NodeIndex_t node,
         const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachIncomingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
 
     void recomputeBeforeRemovingNodes(
         size_t oldNodeCount,
@@ -45,15 +69,48 @@ class AdjacencyMatrix final : public IGraphStorage {
 
     void complete();
 
+    auto neighbours(NodeIndex_t node) const {
+        // Out of range nodes get an empty row, without forming a pointer past the matrix.
+        const auto inRange = node < m_nodeCount;
+        const auto row = inRange ? m_matrix.data() + node * m_capacity : nullptr;
+        const auto columns = inRange ? m_nodeCount : 0;
+
+        return FlaggedLanes{row, columns} | std::views::transform([row](size_t j) {
+                   return std::make_pair(static_cast<NodeIndex_t>(j), decode(row[j]));
+               });
+    }
+
+    auto uniqueNeighbours(NodeIndex_t node) const {
+        return neighbours(node) | std::views::filter([this, node](const auto& neighbour) {
+                   return node < neighbour.first || !(read(neighbour.first, node) & FLAG_BIT);
+               });
+    }
+
+    auto incomingNeighbours(NodeIndex_t node) const {
+        const auto rows = static_cast<NodeIndex_t>(node < m_nodeCount ? m_nodeCount : 0);
+
+        return std::views::iota(NodeIndex_t{0}, rows) |
+               std::views::filter(
+                   [this, node](NodeIndex_t i) { return (read(i, node) & FLAG_BIT) != 0; }) |
+               std::views::transform([this, node](NodeIndex_t i) {
+                   return std::make_pair(i, decode(read(i, node)));
+               });
+    }
+
    private:
-    using UnsignedCostType_t = std::make_unsigned<CostType_t>::type;
+    using UnsignedCostType_t = std::make_unsigned_t<StoredCost_t>;
 
-    static constexpr UnsignedCostType_t FLAG_BIT = 1 << (sizeof(CostType_t) * 8 - 1);
-    static constexpr UnsignedCostType_t COST_MASK = ~FLAG_BIT;
+    static constexpr UnsignedCostType_t FLAG_BIT = UnsignedCostType_t{1}
+                                                   << (sizeof(StoredCost_t) * 8 - 1);
+    static constexpr UnsignedCostType_t COST_MASK = static_cast<UnsignedCostType_t>(~FLAG_BIT);
 
     static UnsignedCostType_t encode(CostType_t cost);
+    static CostType_t decode(UnsignedCostType_t raw);
     UnsignedCostType_t read(NodeIndex_t i, NodeIndex_t j) const;
 
+    void reallocate(size_t capacity);
+
     size_t m_nodeCount{0};
+    size_t m_capacity{0};
     std::vector<UnsignedCostType_t> m_matrix{};
 };
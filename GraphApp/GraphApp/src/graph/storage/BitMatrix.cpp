@@ -0,0 +1,238 @@
+#include <pch.h>
+
+#include "BitMatrix.h"
+
+IGraphStorage::Type BitMatrix::type() const { return Type::BIT_MATRIX; }
+
+void BitMatrix::resize(size_t nodeCount) {
+    if (nodeCount == m_nodeCount) {
+        return;
+    }
+
+    if (nodeCount > m_nodeCount) {
+        return recomputeAfterAddingNode(nodeCount);
+    }
+
+    std::set<NodeIndex_t, std::greater<NodeIndex_t>> removedNodes;
+    for (auto node = static_cast<NodeIndex_t>(nodeCount); node < m_nodeCount; ++node) {
+        removedNodes.insert(node);
+    }
+
+    recomputeBeforeRemovingNodes(m_nodeCount, removedNodes);
+}
+
+void BitMatrix::addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) {
+    if (cost != 0) {
+        throw std::runtime_error{"Bit matrix storage can't hold edge costs!"};
+    }
+
+    m_bits[start * m_wordsPerRow + end / 64] |= Word_t{1} << (end % 64);
+}
+
+void BitMatrix::removeEdge(NodeIndex_t start, NodeIndex_t end) {
+    m_bits[start * m_wordsPerRow + end / 64] &= ~(Word_t{1} << (end % 64));
+}
+
+std::optional<CostType_t> BitMatrix::getEdge(NodeIndex_t start, NodeIndex_t end) const {
+    if (start >= m_nodeCount || end >= m_nodeCount || !test(start, end)) {
+        return std::nullopt;
+    }
+
+    return 0;
+}
+
+void BitMatrix::forEachOutgoingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : uniqueNeighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void BitMatrix::forEachOutgoingEdgeWithOpposites(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : neighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void BitMatrix::forEachIncomingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : incomingNeighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void BitMatrix::recomputeBeforeRemovingNodes(
+    size_t oldNodeCount, const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) {
+    const auto newNodeCount = m_nodeCount - selectedNodes.size();
+    const auto newWordsPerRow = getWordsPerRow(newNodeCount);
+
+    std::vector<NodeIndex_t> indexRemap(m_nodeCount, INVALID_NODE);
+    for (NodeIndex_t oldIndex = 0, newIndex = 0; oldIndex < m_nodeCount; ++oldIndex) {
+        if (!selectedNodes.contains(oldIndex)) {
+            indexRemap[oldIndex] = newIndex++;
+        }
+    }
+
+    std::vector<Word_t> newBits(newNodeCount * newWordsPerRow, 0);
+
+    const auto indices = std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(m_nodeCount));
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
+        const auto new_i = indexRemap[i];
+        if (new_i == INVALID_NODE) {
+            return;
+        }
+
+        auto* newRow = newBits.data() + new_i * newWordsPerRow;
+        for (const auto j : SetBits{getRow(i)}) {
+            const auto new_j = indexRemap[j];
+            if (new_j != INVALID_NODE) {
+                newRow[new_j / 64] |= Word_t{1} << (new_j % 64);
+            }
+        }
+    });
+
+    m_nodeCount = newNodeCount;
+    m_wordsPerRow = newWordsPerRow;
+    m_bits = std::move(newBits);
+}
+
+void BitMatrix::recomputeAfterAddingNode(size_t newNodeCount) {
+    const auto newWordsPerRow = getWordsPerRow(newNodeCount);
+
+    // While the rows still fit in the same number of words only new rows get appended.
+    if (newWordsPerRow == m_wordsPerRow) {
+        m_nodeCount = newNodeCount;
+        m_bits.resize(newNodeCount * m_wordsPerRow, 0);
+        return;
+    }
+
+    std::vector<Word_t> newBits(newNodeCount * newWordsPerRow, 0);
+    for (size_t i = 0; i < m_nodeCount; ++i) {
+        std::copy_n(m_bits.begin() + i * m_wordsPerRow, m_wordsPerRow,
+                    newBits.begin() + i * newWordsPerRow);
+    }
+
+    m_nodeCount = newNodeCount;
+    m_wordsPerRow = newWordsPerRow;
+    m_bits = std::move(newBits);
+}
+
+void BitMatrix::breadthFirstSearch(NodeIndex_t start, std::vector<NodeIndex_t>& parents,
+                                   std::vector<uint32_t>& levels) const {
+    parents.assign(m_nodeCount, INVALID_NODE);
+    levels.assign(m_nodeCount, std::numeric_limits<uint32_t>::max());
+
+    std::vector<Word_t> visited(m_wordsPerRow, 0);
+    std::vector<Word_t> frontier(m_wordsPerRow, 0);
+    std::vector<Word_t> next(m_wordsPerRow, 0);
+
+    visited[start / 64] |= Word_t{1} << (start % 64);
+    frontier[start / 64] |= Word_t{1} << (start % 64);
+    levels[start] = 0;
+
+    for (uint32_t level = 1; std::ranges::any_of(frontier, [](Word_t w) { return w != 0; });
+         ++level) {
+        std::ranges::fill(next, 0);
+
+        for (const auto x : SetBits{frontier}) {
+            const auto row = getRow(x);
+            for (size_t w = 0; w < m_wordsPerRow; ++w) {
+                const auto discovered = row[w] & ~visited[w] & ~next[w];
+                if (discovered == 0) {
+                    continue;
+                }
+
+                next[w] |= discovered;
+                for (const auto y : SetBits{std::span{&discovered, 1}}) {
+                    parents[w * 64 + y] = x;
+                    levels[w * 64 + y] = level;
+                }
+            }
+        }
+
+        for (size_t w = 0; w < m_wordsPerRow; ++w) {
+            visited[w] |= next[w];
+        }
+
+        std::swap(frontier, next);
+    }
+}
+
+std::vector<std::vector<NodeIndex_t>> BitMatrix::reachableComponents(
+    NodeIndex_t firstStart) const {
+    std::vector<std::vector<NodeIndex_t>> components;
+    if (m_nodeCount == 0) {
+        return components;
+    }
+
+    std::vector<Word_t> visited(m_wordsPerRow, 0);
+    std::vector<Word_t> frontier(m_wordsPerRow, 0);
+    std::vector<Word_t> next(m_wordsPerRow, 0);
+    std::vector<Word_t> component(m_wordsPerRow, 0);
+
+    NodeIndex_t start = firstStart;
+    while (start != INVALID_NODE) {
+        std::ranges::fill(frontier, 0);
+        frontier[start / 64] |= Word_t{1} << (start % 64);
+        visited[start / 64] |= Word_t{1} << (start % 64);
+        component = frontier;
+
+        while (std::ranges::any_of(frontier, [](Word_t w) { return w != 0; })) {
+            expandFrontier(frontier, visited, next);
+
+            for (size_t w = 0; w < m_wordsPerRow; ++w) {
+                component[w] |= frontier[w];
+            }
+        }
+
+        auto& nodes = components.emplace_back();
+        for (const auto node : SetBits{component}) {
+            nodes.push_back(node);
+        }
+
+        start = INVALID_NODE;
+        for (size_t w = 0; w < m_wordsPerRow; ++w) {
+            const auto unvisited = ~visited[w];
+            if (unvisited != 0 && w * 64 + std::countr_zero(unvisited) < m_nodeCount) {
+                start = static_cast<NodeIndex_t>(w * 64 + std::countr_zero(unvisited));
+                break;
+            }
+        }
+    }
+
+    return components;
+}
+
+size_t BitMatrix::getWordsPerRow(size_t nodeCount) { return (nodeCount + 63) / 64; }
+
+std::span<const BitMatrix::Word_t> BitMatrix::getRow(NodeIndex_t node) const {
+    if (node >= m_nodeCount) {
+        return {};
+    }
+
+    return {m_bits.data() + node * m_wordsPerRow, m_wordsPerRow};
+}
+
+bool BitMatrix::test(NodeIndex_t start, NodeIndex_t end) const {
+    return (m_bits[start * m_wordsPerRow + end / 64] >> (end % 64)) & 1;
+}
+
+void BitMatrix::expandFrontier(std::vector<Word_t>& frontier, std::vector<Word_t>& visited,
+                               std::vector<Word_t>& next) const {
+    std::ranges::fill(next, 0);
+
+    for (const auto x : SetBits{frontier}) {
+        const auto row = getRow(x);
+        for (size_t w = 0; w < m_wordsPerRow; ++w) {
+            next[w] |= row[w];
+        }
+    }
+
+    for (size_t w = 0; w < m_wordsPerRow; ++w) {
+        next[w] &= ~visited[w];
+        visited[w] |= next[w];
+    }
+
+    std::swap(frontier, next);
+}
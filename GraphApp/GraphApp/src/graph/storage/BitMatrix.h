@@ -0,0 +1,132 @@
+#pragma once
+
+#include "IGraphStorage.h"
+
+/**
+ * @class BitMatrix
+ * @brief Adjacency matrix with a single bit per cell, for unweighted graphs.
+ *
+ * Storage Format:
+ * - Every row is m_wordsPerRow 64-bit words, bit (j % 64) of word (j / 64) set
+ *   meaning the edge (i, j) exists
+ * - Bits past the last node of a row are always zero
+ *
+ * Every edge has cost 0. GraphManager promotes the graph to a weighted storage
+ * before adding an edge with any other cost. Rows are plain bitsets, so the
+ * traversal kernels below expand a whole frontier with word-wide OR/AND-NOT
+ * instead of visiting edges one at a time.
+ */
+class BitMatrix final : public IGraphStorage {
+   public:
+    using Word_t = uint64_t;
+
+    class SetBits : public std::ranges::view_interface<SetBits> {
+       public:
+        class Iterator {
+           public:
+            using value_type = NodeIndex_t;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            Iterator(std::span<const Word_t> words) : m_words(words) {
+                if (!m_words.empty()) {
+                    m_word = m_words[0];
+                    skipEmptyWords();
+                }
+            }
+
+            NodeIndex_t operator*() const {
+                return static_cast<NodeIndex_t>(m_wordIndex * 64 + std::countr_zero(m_word));
+            }
+
+            Iterator& operator++() {
+                m_word &= m_word - 1;
+                skipEmptyWords();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const { return m_word == 0; }
+
+           private:
+            void skipEmptyWords() {
+                while (m_word == 0 && ++m_wordIndex < m_words.size()) {
+                    m_word = m_words[m_wordIndex];
+                }
+            }
+
+            std::span<const Word_t> m_words{};
+            size_t m_wordIndex{0};
+            Word_t m_word{0};
+        };
+
+        SetBits(std::span<const Word_t> words) : m_words(words) {}
+
+        Iterator begin() const { return Iterator{m_words}; }
+        std::default_sentinel_t end() const { return {}; }
+
+       private:
+        std::span<const Word_t> m_words;
+    };
+
+    Type type() const override;
+
+    void resize(size_t nodeCount) override;
+
+    void addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) override;
+    void removeEdge(NodeIndex_t start, NodeIndex_t end) override;
+
+    std::optional<CostType_t> getEdge(NodeIndex_t start, NodeIndex_t end) const override;
+
+    void forEachOutgoingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachOutgoingEdgeWithOpposites(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachIncomingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+
+    void recomputeBeforeRemovingNodes(
+        size_t oldNodeCount,
+        const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) override;
+    void recomputeAfterAddingNode(size_t newNodeCount) override;
+
+    auto neighbours(NodeIndex_t node) const {
+        return SetBits{getRow(node)} |
+               std::views::transform([](NodeIndex_t j) { return std::make_pair(j, CostType_t{0}); });
+    }
+
+    auto uniqueNeighbours(NodeIndex_t node) const {
+        return neighbours(node) | std::views::filter([this, node](const auto& neighbour) {
+                   return node < neighbour.first || !test(neighbour.first, node);
+               });
+    }
+
+    auto incomingNeighbours(NodeIndex_t node) const {
+        const auto rows = static_cast<NodeIndex_t>(node < m_nodeCount ? m_nodeCount : 0);
+
+        return std::views::iota(NodeIndex_t{0}, rows) |
+               std::views::filter([this, node](NodeIndex_t i) { return test(i, node); }) |
+               std::views::transform([](NodeIndex_t i) { return std::make_pair(i, CostType_t{0}); });
+    }
+
+    void breadthFirstSearch(NodeIndex_t start, std::vector<NodeIndex_t>& parents,
+                            std::vector<uint32_t>& levels) const;
+    std::vector<std::vector<NodeIndex_t>> reachableComponents(NodeIndex_t firstStart) const;
+
+   private:
+    static size_t getWordsPerRow(size_t nodeCount);
+
+    std::span<const Word_t> getRow(NodeIndex_t node) const;
+    bool test(NodeIndex_t start, NodeIndex_t end) const;
+
+    void expandFrontier(std::vector<Word_t>& frontier, std::vector<Word_t>& visited,
+                        std::vector<Word_t>& next) const;
+
+    size_t m_nodeCount{0};
+    size_t m_wordsPerRow{0};
+    std::vector<Word_t> m_bits{};
+};
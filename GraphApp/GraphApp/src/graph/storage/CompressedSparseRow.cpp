@@ -0,0 +1,243 @@
+#include <pch.h>
+
+#include "CompressedSparseRow.h"
+
+CompressedSparseRow::CompressedSparseRow(const IGraphStorage& source, size_t nodeCount) {
+    std::vector<size_t> degrees(nodeCount, 0);
+
+    const auto indices = std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(nodeCount));
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
+        source.forEachOutgoingEdgeWithOpposites(i, [&](NodeIndex_t, CostType_t) { ++degrees[i]; });
+    });
+
+    m_ownedOffsets.resize(nodeCount + 1);
+    m_ownedOffsets[0] = 0;
+    std::inclusive_scan(degrees.begin(), degrees.end(), m_ownedOffsets.begin() + 1);
+
+    m_ownedTargets.resize(m_ownedOffsets.back());
+    m_ownedCosts.resize(m_ownedOffsets.back());
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
+        auto position = m_ownedOffsets[i];
+        source.forEachOutgoingEdgeWithOpposites(i, [&](NodeIndex_t j, CostType_t cost) {
+            m_ownedTargets[position] = j;
+            m_ownedCosts[position] = cost;
+            ++position;
+        });
+    });
+
+    viewOwnedArrays();
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
+        for (auto position = m_offsets[i]; position < m_offsets[i + 1]; ++position) {
+            const auto j = m_targets[position] & TARGET_MASK;
+            if (findTarget(j, i) != m_targets.end()) {
+                m_ownedTargets[position] |= OPPOSITE_BIT;
+            }
+        }
+    });
+}
+
+CompressedSparseRow::CompressedSparseRow(std::span<const size_t> offsets,
+                                         std::span<const NodeIndex_t> targets,
+                                         std::span<const CostType_t> costs,
+                                         std::shared_ptr<const void> owner)
+    : m_externalOwner(std::move(owner)), m_offsets(offsets), m_targets(targets), m_costs(costs) {
+    if (offsets.empty() || offsets.front() != 0 || offsets.back() != targets.size() ||
+        targets.size() != costs.size() || !std::ranges::is_sorted(offsets)) {
+        throw std::runtime_error{"Compressed sparse row arrays don't match!"};
+    }
+
+    const auto nodeCount = getNodeCount();
+    if (!std::all_of(std::execution::par, targets.begin(), targets.end(),
+                     [&](NodeIndex_t target) { return (target & TARGET_MASK) < nodeCount; })) {
+        throw std::runtime_error{"Compressed sparse row targets are out of range!"};
+    }
+
+    // findTarget binary searches the rows, which needs them strictly ascending.
+    const auto indices = std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(nodeCount));
+    if (!std::all_of(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
+            const auto row = targets.subspan(offsets[i], offsets[i + 1] - offsets[i]);
+            return std::ranges::adjacent_find(row, std::greater_equal{}, [](NodeIndex_t target) {
+                       return target & TARGET_MASK;
+                   }) == row.end();
+        })) {
+        throw std::runtime_error{"Compressed sparse row targets are not sorted!"};
+    }
+
+    // Unique edge enumeration trusts the opposite flags, so they must match the rows.
+    if (!std::all_of(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
+            for (auto position = offsets[i]; position < offsets[i + 1]; ++position) {
+                const auto j = targets[position] & TARGET_MASK;
+                const bool hasOpposite = findTarget(j, i) != m_targets.end();
+                if (hasOpposite != static_cast<bool>(targets[position] & OPPOSITE_BIT)) {
+                    return false;
+                }
+            }
+            return true;
+        })) {
+        throw std::runtime_error{"Compressed sparse row opposite flags don't match the edges!"};
+    }
+}
+
+IGraphStorage::Type CompressedSparseRow::type() const { return Type::COMPRESSED_SPARSE_ROW; }
+
+void CompressedSparseRow::resize(size_t nodeCount) {
+    if (nodeCount < getNodeCount()) {
+        throw std::runtime_error{"Compressed sparse row storage can't be shrunk!"};
+    }
+
+    copyExternalArrays();
+    m_ownedOffsets.resize(nodeCount + 1, m_ownedOffsets.back());
+    viewOwnedArrays();
+}
+
+void CompressedSparseRow::addEdge(NodeIndex_t, NodeIndex_t, CostType_t) {
+    throw std::runtime_error{"Tried adding an edge to a read-only graph storage!"};
+}
+
+void CompressedSparseRow::removeEdge(NodeIndex_t, NodeIndex_t) {
+    throw std::runtime_error{"Tried removing an edge from a read-only graph storage!"};
+}
+
+std::optional<CostType_t> CompressedSparseRow::getEdge(NodeIndex_t start, NodeIndex_t end) const {
+    if (start >= getNodeCount()) {
+        return std::nullopt;
+    }
+
+    const auto it = findTarget(start, end);
+    if (it == m_targets.end()) {
+        return std::nullopt;
+    }
+
+    return m_costs[std::distance(m_targets.begin(), it)];
+}
+
+void CompressedSparseRow::forEachOutgoingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : uniqueNeighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void CompressedSparseRow::forEachOutgoingEdgeWithOpposites(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : neighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void CompressedSparseRow::forEachIncomingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : incomingNeighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void CompressedSparseRow::recomputeBeforeRemovingNodes(
+    size_t oldNodeCount, const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) {
+    m_incomingEdges.clear();
+    copyExternalArrays();
+
+    std::vector<NodeIndex_t> indexRemap(oldNodeCount, INVALID_NODE);
+    for (NodeIndex_t oldIndex = 0, newIndex = 0; oldIndex < oldNodeCount; ++oldIndex) {
+        if (!selectedNodes.contains(oldIndex)) {
+            indexRemap[oldIndex] = newIndex++;
+        }
+    }
+
+    std::vector<size_t> newOffsets;
+    newOffsets.reserve(oldNodeCount - selectedNodes.size() + 1);
+    newOffsets.push_back(0);
+
+    size_t writePosition = 0;
+    for (NodeIndex_t start = 0; start < oldNodeCount; ++start) {
+        if (indexRemap[start] == INVALID_NODE) {
+            continue;
+        }
+
+        // Rows only ever move towards the front, so the compaction can happen in place. The
+        // remap is monotonic, which keeps every row sorted.
+        for (auto i = m_ownedOffsets[start]; i < m_ownedOffsets[start + 1]; ++i) {
+            const auto newEnd = indexRemap[m_ownedTargets[i] & TARGET_MASK];
+            if (newEnd != INVALID_NODE) {
+                m_ownedTargets[writePosition] = newEnd | (m_ownedTargets[i] & OPPOSITE_BIT);
+                m_ownedCosts[writePosition] = m_ownedCosts[i];
+                ++writePosition;
+            }
+        }
+
+        newOffsets.push_back(writePosition);
+    }
+
+    m_ownedTargets.resize(writePosition);
+    m_ownedTargets.shrink_to_fit();
+    m_ownedCosts.resize(writePosition);
+    m_ownedCosts.shrink_to_fit();
+    m_ownedOffsets = std::move(newOffsets);
+    viewOwnedArrays();
+}
+
+void CompressedSparseRow::recomputeAfterAddingNode(size_t newNodeCount) { resize(newNodeCount); }
+
+size_t CompressedSparseRow::getEdgeCount() const { return m_targets.size(); }
+
+std::span<const size_t> CompressedSparseRow::getOffsets() const { return m_offsets; }
+
+std::span<const NodeIndex_t> CompressedSparseRow::getTargets() const { return m_targets; }
+
+std::span<const CostType_t> CompressedSparseRow::getCosts() const { return m_costs; }
+
+std::ranges::iota_view<size_t, size_t> CompressedSparseRow::getRow(NodeIndex_t node) const {
+    if (node >= getNodeCount()) {
+        return {};
+    }
+
+    return std::views::iota(m_offsets[node], m_offsets[node + 1]);
+}
+
+std::span<const NodeIndex_t>::iterator CompressedSparseRow::findTarget(NodeIndex_t start,
+                                                                      NodeIndex_t end) const {
+    const auto rowBegin = m_targets.begin() + m_offsets[start];
+    const auto rowEnd = m_targets.begin() + m_offsets[start + 1];
+
+    const auto it =
+        std::lower_bound(rowBegin, rowEnd, end, [](NodeIndex_t target, NodeIndex_t value) {
+            return (target & TARGET_MASK) < value;
+        });
+    if (it == rowEnd || (*it & TARGET_MASK) != end) {
+        return m_targets.end();
+    }
+
+    return it;
+}
+
+void CompressedSparseRow::viewOwnedArrays() {
+    m_offsets = m_ownedOffsets;
+    m_targets = m_ownedTargets;
+    m_costs = m_ownedCosts;
+}
+
+void CompressedSparseRow::copyExternalArrays() {
+    if (!m_externalOwner) {
+        return;
+    }
+
+    m_ownedOffsets.assign(m_offsets.begin(), m_offsets.end());
+    m_ownedTargets.assign(m_targets.begin(), m_targets.end());
+    m_ownedCosts.assign(m_costs.begin(), m_costs.end());
+    m_externalOwner.reset();
+    viewOwnedArrays();
+}
+
+size_t CompressedSparseRow::getNodeCount() const { return m_offsets.size() - 1; }
+
+// Growing the storage keeps the index valid: new nodes have no incoming edges yet.
+const IncomingEdgeIndex& CompressedSparseRow::getIncomingEdges() const {
+    std::scoped_lock lock{m_incomingEdgesMutex};
+    if (!m_incomingEdges.isBuilt()) {
+        m_incomingEdges.build(*this, getNodeCount());
+    }
+
+    return m_incomingEdges;
+}
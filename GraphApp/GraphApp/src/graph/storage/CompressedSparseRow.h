@@ -0,0 +1,113 @@
+#pragma once
+
+#include "IGraphStorage.h"
+#include "IncomingEdgeIndex.h"
+
+/**
+ * @class CompressedSparseRow
+ * @brief Immutable compressed sparse row storage for read-only graphs.
+ *
+ * Storage Format:
+ * - m_offsets: nodeCount + 1 entries, row i spans [m_offsets[i], m_offsets[i + 1])
+ * - m_targets: neighbour indices of every row, sorted ascending inside a row;
+ *              the MSB marks that the opposite edge exists as well
+ * - m_costs:   edge costs, parallel to m_targets
+ *
+ * All neighbours of a node live next to each other in memory, so enumerating
+ * them is a linear scan instead of one pointer dereference per node.
+ *
+ * Edges cannot be added or removed; GraphManager thaws the graph back into a
+ * mutable storage before any edge edit. Adding or removing nodes is supported
+ * since it only has to touch the offsets (or remap the rows once).
+ *
+ * The arrays are read through spans, which either view the owned vectors or
+ * memory owned by someone else (a mapped binary graph file, kept alive by
+ * m_externalOwner). External arrays are copied into the vectors the first time
+ * the storage gets resized or nodes get removed.
+ *
+ * Incoming edges come from an IncomingEdgeIndex built on the first query.
+ */
+class CompressedSparseRow final : public IGraphStorage {
+   public:
+    CompressedSparseRow() = default;
+    CompressedSparseRow(const IGraphStorage& source, size_t nodeCount);
+    CompressedSparseRow(std::span<const size_t> offsets, std::span<const NodeIndex_t> targets,
+                        std::span<const CostType_t> costs, std::shared_ptr<const void> owner);
+
+    Type type() const override;
+
+    void resize(size_t nodeCount) override;
+
+    void addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) override;
+    void removeEdge(NodeIndex_t start, NodeIndex_t end) override;
+
+    std::optional<CostType_t> getEdge(NodeIndex_t start, NodeIndex_t end) const override;
+
+    void forEachOutgoingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachOutgoingEdgeWithOpposites(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachIncomingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+
+    void recomputeBeforeRemovingNodes(
+        size_t oldNodeCount,
+        const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) override;
+    void recomputeAfterAddingNode(size_t newNodeCount) override;
+
+    auto neighbours(NodeIndex_t node) const {
+        return getRow(node) | std::views::transform([this](size_t i) {
+                   return std::make_pair(m_targets[i] & TARGET_MASK, m_costs[i]);
+               });
+    }
+
+    auto uniqueNeighbours(NodeIndex_t node) const {
+        return getRow(node) | std::views::filter([this, node](size_t i) {
+                   return !(m_targets[i] & OPPOSITE_BIT) || node < (m_targets[i] & TARGET_MASK);
+               }) |
+               std::views::transform([this](size_t i) {
+                   return std::make_pair(m_targets[i] & TARGET_MASK, m_costs[i]);
+               });
+    }
+
+    auto incomingNeighbours(NodeIndex_t node) const {
+        return getIncomingEdges().neighbours(node);
+    }
+
+    size_t getEdgeCount() const;
+
+    // Raw arrays in the format described above, targets still carrying the opposite bit.
+    std::span<const size_t> getOffsets() const;
+    std::span<const NodeIndex_t> getTargets() const;
+    std::span<const CostType_t> getCosts() const;
+
+    // Stops reading from external memory, e.g. before its file gets overwritten.
+    void copyExternalArrays();
+
+   private:
+    static constexpr NodeIndex_t OPPOSITE_BIT = NodeIndex_t{1} << (sizeof(NodeIndex_t) * 8 - 1);
+    static constexpr NodeIndex_t TARGET_MASK = ~OPPOSITE_BIT;
+
+    std::ranges::iota_view<size_t, size_t> getRow(NodeIndex_t node) const;
+    std::span<const NodeIndex_t>::iterator findTarget(NodeIndex_t start, NodeIndex_t end) const;
+
+    void viewOwnedArrays();
+
+    size_t getNodeCount() const;
+    const IncomingEdgeIndex& getIncomingEdges() const;
+
+    std::vector<size_t> m_ownedOffsets{0};
+    std::vector<NodeIndex_t> m_ownedTargets{};
+    std::vector<CostType_t> m_ownedCosts{};
+    std::shared_ptr<const void> m_externalOwner{};
+
+    std::span<const size_t> m_offsets{m_ownedOffsets};
+    std::span<const NodeIndex_t> m_targets{};
+    std::span<const CostType_t> m_costs{};
+
+    mutable IncomingEdgeIndex m_incomingEdges;
+    mutable std::mutex m_incomingEdgesMutex;
+};
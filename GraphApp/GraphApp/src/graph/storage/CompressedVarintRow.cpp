@@ -0,0 +1,212 @@
+#include <pch.h>
+
+#include "CompressedVarintRow.h"
+
+static size_t writeVarint(uint64_t value, uint8_t* bytes) {
+    size_t length = 1;
+    while (value >= 0x80) {
+        if (bytes) {
+            *bytes++ = static_cast<uint8_t>(value | 0x80);
+        }
+        value >>= 7;
+        ++length;
+    }
+
+    if (bytes) {
+        *bytes = static_cast<uint8_t>(value);
+    }
+
+    return length;
+}
+
+static uint64_t encodeCost(CostType_t cost) {
+    const auto value = static_cast<int64_t>(cost);
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+CompressedVarintRow::CompressedVarintRow(const IGraphStorage& source, size_t nodeCount) {
+    build(nodeCount, [&](NodeIndex_t i, std::vector<Entry_t>& entries) {
+        source.forEachOutgoingEdgeWithOpposites(i, [&](NodeIndex_t j, CostType_t cost) {
+            entries.push_back({j, cost, i == j || source.getEdge(j, i).has_value()});
+        });
+
+        std::ranges::sort(entries, {}, &Entry_t::m_target);
+    });
+}
+
+IGraphStorage::Type CompressedVarintRow::type() const { return Type::COMPRESSED_VARINT_ROW; }
+
+void CompressedVarintRow::resize(size_t nodeCount) {
+    if (nodeCount < getNodeCount()) {
+        throw std::runtime_error{"Compressed varint row storage can't be shrunk!"};
+    }
+
+    while (getNodeCount() < nodeCount) {
+        pushRowOffsets(m_targetBytes.size(), m_costBytes.size());
+    }
+}
+
+void CompressedVarintRow::addEdge(NodeIndex_t, NodeIndex_t, CostType_t) {
+    throw std::runtime_error{"Tried adding an edge to a read-only graph storage!"};
+}
+
+void CompressedVarintRow::removeEdge(NodeIndex_t, NodeIndex_t) {
+    throw std::runtime_error{"Tried removing an edge from a read-only graph storage!"};
+}
+
+std::optional<CostType_t> CompressedVarintRow::getEdge(NodeIndex_t start, NodeIndex_t end) const {
+    for (const auto& entry : getRow(start)) {
+        if (entry.m_target >= end) {
+            return entry.m_target == end ? std::optional{entry.m_cost} : std::nullopt;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void CompressedVarintRow::forEachOutgoingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : uniqueNeighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void CompressedVarintRow::forEachOutgoingEdgeWithOpposites(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : neighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void CompressedVarintRow::forEachIncomingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : incomingNeighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void CompressedVarintRow::recomputeBeforeRemovingNodes(
+    size_t oldNodeCount, const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) {
+    std::vector<NodeIndex_t> indexRemap(oldNodeCount, INVALID_NODE);
+    std::vector<NodeIndex_t> survivors;
+    for (NodeIndex_t oldIndex = 0, newIndex = 0; oldIndex < oldNodeCount; ++oldIndex) {
+        if (!selectedNodes.contains(oldIndex)) {
+            indexRemap[oldIndex] = newIndex++;
+            survivors.push_back(oldIndex);
+        }
+    }
+
+    // The remap is monotonic and both directions of an edge survive or vanish
+    // together, so rows stay sorted and the opposite flags stay valid.
+    CompressedVarintRow old;
+    std::swap(m_targetBytes, old.m_targetBytes);
+    std::swap(m_costBytes, old.m_costBytes);
+    std::swap(m_blockOffsets, old.m_blockOffsets);
+    std::swap(m_rowOffsets, old.m_rowOffsets);
+
+    build(survivors.size(), [&](NodeIndex_t i, std::vector<Entry_t>& entries) {
+        for (const auto& entry : old.getRow(survivors[i])) {
+            const auto newTarget = indexRemap[entry.m_target];
+            if (newTarget != INVALID_NODE) {
+                entries.push_back({newTarget, entry.m_cost, entry.m_hasOpposite});
+            }
+        }
+    });
+}
+
+void CompressedVarintRow::recomputeAfterAddingNode(size_t newNodeCount) { resize(newNodeCount); }
+
+void CompressedVarintRow::build(size_t nodeCount, const RowSource_t& rowSource) {
+    m_incomingEdges.clear();
+
+    // Rows are encoded twice, once to size them and once to write them, so both
+    // passes can run in parallel without growing the streams.
+    std::vector<std::pair<size_t, size_t>> rowLengths(nodeCount);
+    const auto indices = std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(nodeCount));
+
+    const auto encodeRow = [&](NodeIndex_t i, uint8_t* targets, uint8_t* costs) {
+        thread_local std::vector<Entry_t> entries;
+        entries.clear();
+        rowSource(i, entries);
+
+        size_t targetsLength = 0, costsLength = 0;
+        NodeIndex_t previous = 0;
+        for (const auto& [target, cost, hasOpposite] : entries) {
+            const auto gap = (uint64_t{target - previous} << 1) | (hasOpposite ? 1 : 0);
+            targetsLength += writeVarint(gap, targets ? targets + targetsLength : nullptr);
+            costsLength += writeVarint(encodeCost(cost), costs ? costs + costsLength : nullptr);
+            previous = target;
+        }
+
+        return std::make_pair(targetsLength, costsLength);
+    };
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(),
+                  [&](NodeIndex_t i) { rowLengths[i] = encodeRow(i, nullptr, nullptr); });
+
+    std::vector<std::pair<size_t, size_t>> rowBegins(nodeCount + 1, {0, 0});
+    for (size_t i = 0; i < nodeCount; ++i) {
+        rowBegins[i + 1] = {rowBegins[i].first + rowLengths[i].first,
+                            rowBegins[i].second + rowLengths[i].second};
+    }
+
+    m_targetBytes.assign(rowBegins.back().first, 0);
+    m_costBytes.assign(rowBegins.back().second, 0);
+    m_targetBytes.shrink_to_fit();
+    m_costBytes.shrink_to_fit();
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
+        encodeRow(i, m_targetBytes.data() + rowBegins[i].first,
+                  m_costBytes.data() + rowBegins[i].second);
+    });
+
+    m_blockOffsets.clear();
+    m_rowOffsets.clear();
+    m_rowOffsets.reserve(nodeCount + 1);
+    for (const auto& [targetsOffset, costsOffset] : rowBegins) {
+        pushRowOffsets(targetsOffset, costsOffset);
+    }
+}
+
+CompressedVarintRow::Row CompressedVarintRow::getRow(NodeIndex_t node) const {
+    if (node >= getNodeCount()) {
+        return {};
+    }
+
+    const auto [targetsBegin, costsBegin] = getRowBegin(node);
+    const auto targetsEnd = getRowBegin(node + 1).first;
+
+    return Row{m_targetBytes.data() + targetsBegin, m_targetBytes.data() + targetsEnd,
+               m_costBytes.data() + costsBegin};
+}
+
+std::pair<size_t, size_t> CompressedVarintRow::getRowBegin(NodeIndex_t node) const {
+    const auto& [blockTargets, blockCosts] = m_blockOffsets[node / ROWS_PER_BLOCK];
+    const auto& [rowTargets, rowCosts] = m_rowOffsets[node];
+
+    return {blockTargets + rowTargets, blockCosts + rowCosts};
+}
+
+void CompressedVarintRow::pushRowOffsets(size_t targetsOffset, size_t costsOffset) {
+    if (m_rowOffsets.size() % ROWS_PER_BLOCK == 0) {
+        m_blockOffsets.push_back({targetsOffset, costsOffset});
+    }
+
+    const auto& [blockTargets, blockCosts] = m_blockOffsets.back();
+    m_rowOffsets.push_back({static_cast<uint32_t>(targetsOffset - blockTargets),
+                            static_cast<uint32_t>(costsOffset - blockCosts)});
+}
+
+size_t CompressedVarintRow::getNodeCount() const {
+    return m_rowOffsets.empty() ? 0 : m_rowOffsets.size() - 1;
+}
+
+// Growing the storage keeps the index valid: new nodes have no incoming edges yet.
+const IncomingEdgeIndex& CompressedVarintRow::getIncomingEdges() const {
+    std::scoped_lock lock{m_incomingEdgesMutex};
+    if (!m_incomingEdges.isBuilt()) {
+        m_incomingEdges.build(*this, getNodeCount());
+    }
+
+    return m_incomingEdges;
+}
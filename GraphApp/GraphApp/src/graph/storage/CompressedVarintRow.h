@@ -0,0 +1,189 @@
+#pragma once
+
+#include "IGraphStorage.h"
+#include "IncomingEdgeIndex.h"
+
+/**
+ * @class CompressedVarintRow
+ * @brief Read-only sparse row storage with gap encoded, variable length entries.
+ *
+ * Storage Format:
+ * - m_targetBytes: per row, the sorted neighbours as LEB128 varints of
+ *                  (gap to the previous neighbour << 1 | has opposite edge);
+ *                  the first gap is taken from 0
+ * - m_costBytes:   per row, the costs as zigzag LEB128 varints, in target order
+ * - m_blockOffsets[b]: byte offsets of row b * ROWS_PER_BLOCK in both streams
+ * - m_rowOffsets[i]:   byte offsets of row i relative to its block, nodeCount + 1
+ *                      entries so row i ends where row i + 1 starts
+ *
+ * Road graphs, especially after a locality reordering, have small gaps and
+ * small costs, so an entry usually takes two to four bytes over both streams
+ * instead of the eight of a CompressedSparseRow entry, and row offsets take
+ * 8 bytes per node. Rows decode front to back, so getEdge is a linear scan of
+ * the row rather than a binary search.
+ *
+ * Like CompressedSparseRow, edges cannot be added or removed; GraphManager
+ * freezes into this storage instead of a CompressedSparseRow once a graph is
+ * large enough for memory to matter more than random access.
+ */
+class CompressedVarintRow final : public IGraphStorage {
+   public:
+    struct Entry_t {
+        NodeIndex_t m_target;
+        CostType_t m_cost;
+        bool m_hasOpposite;
+    };
+
+    class Row : public std::ranges::view_interface<Row> {
+       public:
+        class Iterator {
+           public:
+            using value_type = Entry_t;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            Iterator(const Row& row)
+                : m_targets(row.m_targets), m_targetsEnd(row.m_targetsEnd), m_costs(row.m_costs) {
+                advance();
+            }
+
+            value_type operator*() const { return m_current; }
+
+            Iterator& operator++() {
+                advance();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const { return m_done; }
+
+           private:
+            void advance() {
+                if (m_targets == m_targetsEnd) {
+                    m_done = true;
+                    return;
+                }
+
+                const auto target = readVarint(m_targets);
+                m_previous += static_cast<NodeIndex_t>(target >> 1);
+
+                m_current = {m_previous, decodeCost(readVarint(m_costs)), (target & 1) != 0};
+            }
+
+            const uint8_t* m_targets{nullptr};
+            const uint8_t* m_targetsEnd{nullptr};
+            const uint8_t* m_costs{nullptr};
+
+            NodeIndex_t m_previous{0};
+            value_type m_current{};
+            bool m_done{false};
+        };
+
+        Row() = default;
+        Row(const uint8_t* targets, const uint8_t* targetsEnd, const uint8_t* costs)
+            : m_targets(targets), m_targetsEnd(targetsEnd), m_costs(costs) {}
+
+        Iterator begin() const { return Iterator{*this}; }
+        std::default_sentinel_t end() const { return {}; }
+
+       private:
+        const uint8_t* m_targets{nullptr};
+        const uint8_t* m_targetsEnd{nullptr};
+        const uint8_t* m_costs{nullptr};
+    };
+
+    CompressedVarintRow() = default;
+    CompressedVarintRow(const IGraphStorage& source, size_t nodeCount);
+
+    Type type() const override;
+
+    void resize(size_t nodeCount) override;
+
+    void addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) override;
+    void removeEdge(NodeIndex_t start, NodeIndex_t end) override;
+
+    std::optional<CostType_t> getEdge(NodeIndex_t start, NodeIndex_t end) const override;
+
+    void forEachOutgoingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachOutgoingEdgeWithOpposites(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachIncomingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+
+    void recomputeBeforeRemovingNodes(
+        size_t oldNodeCount,
+        const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) override;
+    void recomputeAfterAddingNode(size_t newNodeCount) override;
+
+    auto neighbours(NodeIndex_t node) const {
+        return getRow(node) | std::views::transform([](const Entry_t& entry) {
+                   return std::make_pair(entry.m_target, entry.m_cost);
+               });
+    }
+
+    auto uniqueNeighbours(NodeIndex_t node) const {
+        return getRow(node) | std::views::filter([node](const Entry_t& entry) {
+                   return !entry.m_hasOpposite || node < entry.m_target;
+               }) |
+               std::views::transform([](const Entry_t& entry) {
+                   return std::make_pair(entry.m_target, entry.m_cost);
+               });
+    }
+
+    auto incomingNeighbours(NodeIndex_t node) const {
+        return getIncomingEdges().neighbours(node);
+    }
+
+   private:
+    static constexpr size_t ROWS_PER_BLOCK = 64;
+
+    struct RowOffsets_t {
+        uint32_t m_targets;
+        uint32_t m_costs;
+    };
+
+    static uint64_t readVarint(const uint8_t*& bytes) {
+        uint64_t value = *bytes++;
+        if (value < 0x80) {
+            return value;
+        }
+
+        value &= 0x7f;
+        for (uint32_t shift = 7;; shift += 7) {
+            const uint64_t byte = *bytes++;
+            value |= (byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    static CostType_t decodeCost(uint64_t zigzag) {
+        return static_cast<CostType_t>(static_cast<int64_t>(zigzag >> 1) ^
+                                       -static_cast<int64_t>(zigzag & 1));
+    }
+
+    // Fills entries with the sorted row of node; the opposite flags must be set.
+    using RowSource_t = std::function<void(NodeIndex_t, std::vector<Entry_t>&)>;
+    void build(size_t nodeCount, const RowSource_t& rowSource);
+
+    Row getRow(NodeIndex_t node) const;
+    std::pair<size_t, size_t> getRowBegin(NodeIndex_t node) const;
+    void pushRowOffsets(size_t targetsOffset, size_t costsOffset);
+
+    size_t getNodeCount() const;
+    const IncomingEdgeIndex& getIncomingEdges() const;
+
+    std::vector<uint8_t> m_targetBytes{};
+    std::vector<uint8_t> m_costBytes{};
+    std::vector<std::pair<size_t, size_t>> m_blockOffsets{};
+    std::vector<RowOffsets_t> m_rowOffsets{};
+
+    mutable IncomingEdgeIndex m_incomingEdges;
+    mutable std::mutex m_incomingEdgesMutex;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @class FlaggedLanes
+ * @brief Range over the indices of packed entries whose most significant bit is set.
+ *
+ * The row is tested one SIMD register at a time (32 bytes with AVX2, 16 bytes
+ * with SSE2, 8 bytes otherwise): a byte movemask keeps only the top byte of
+ * every lane, and set lanes are then popped with countr_zero. Empty stretches
+ * of the row therefore cost one load and one compare per block instead of one
+ * branch per entry.
+ */
+template <typename Element>
+class FlaggedLanes : public std::ranges::view_interface<FlaggedLanes<Element>> {
+    static_assert(std::is_unsigned_v<Element>, "FlaggedLanes expects unsigned entries");
+
+#if defined(__AVX2__)
+    static constexpr size_t k_blockBytes = 32;
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    static constexpr size_t k_blockBytes = 16;
+#else
+    static constexpr size_t k_blockBytes = 8;
+#endif
+
+    using Mask_t = std::conditional_t<k_blockBytes == 32, uint32_t, uint16_t>;
+
+    static constexpr size_t k_lanes = k_blockBytes / sizeof(Element);
+    static constexpr Mask_t k_topByteMask = [] {
+        Mask_t mask = 0;
+        for (size_t lane = 0; lane < k_lanes; ++lane) {
+            mask |= Mask_t{1} << (lane * sizeof(Element) + sizeof(Element) - 1);
+        }
+        return mask;
+    }();
+
+    static Mask_t scalarMask(const Element* block, size_t count) {
+        constexpr Element flag = Element{1} << (sizeof(Element) * 8 - 1);
+
+        Mask_t mask = 0;
+        for (size_t lane = 0; lane < count; ++lane) {
+            if (block[lane] & flag) {
+                mask |= Mask_t{1} << (lane * sizeof(Element) + sizeof(Element) - 1);
+            }
+        }
+        return mask;
+    }
+
+    static Mask_t blockMask(const Element* block) {
+#if defined(__AVX2__)
+        const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        return static_cast<Mask_t>(_mm256_movemask_epi8(bytes)) & k_topByteMask;
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+        return static_cast<Mask_t>(_mm_movemask_epi8(bytes)) & k_topByteMask;
+#else
+        return scalarMask(block, k_lanes);
+#endif
+    }
+
+   public:
+    class Iterator {
+       public:
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(const Element* row, size_t count) : m_row(row), m_count(count) {
+            if (m_count == 0) {
+                return;
+            }
+
+            m_mask = loadMask();
+            skipEmptyBlocks();
+        }
+
+        size_t operator*() const { return m_base + std::countr_zero(m_mask) / sizeof(Element); }
+
+        Iterator& operator++() {
+            m_mask &= m_mask - 1;
+            skipEmptyBlocks();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return m_mask == 0; }
+
+       private:
+        Mask_t loadMask() const {
+            const auto remaining = m_count - m_base;
+            return remaining >= k_lanes ? blockMask(m_row + m_base)
+                                        : scalarMask(m_row + m_base, remaining);
+        }
+
+        void skipEmptyBlocks() {
+            while (m_mask == 0) {
+                m_base += k_lanes;
+                if (m_base >= m_count) {
+                    return;
+                }
+
+                m_mask = loadMask();
+            }
+        }
+
+        const Element* m_row{nullptr};
+        size_t m_count{0};
+        size_t m_base{0};
+        Mask_t m_mask{0};
+    };
+
+    FlaggedLanes(const Element* row, size_t count) : m_row(row), m_count(count) {}
+
+    Iterator begin() const { return Iterator{m_row, m_count}; }
+    std::default_sentinel_t end() const { return {}; }
+
+   private:
+    const Element* m_row;
+    size_t m_count;
+};
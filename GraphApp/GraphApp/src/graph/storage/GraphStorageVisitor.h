@@ -0,0 +1,101 @@
+#pragma once
+
+#include "AdjacencyList.h"
+#include "AdjacencyMatrix.h"
+#include "BitMatrix.h"
+#include "CompressedSparseRow.h"
+#include "CompressedVarintRow.h"
+#include "ImplicitCompleteGraph.h"
+
+/**
+ * Hands the visitor a std::type_identity of the stored cost type matching width,
+ * so storages templated on their cost width can be named from a runtime value.
+ */
+template <typename Visitor>
+decltype(auto) visitCostWidth(IGraphStorage::CostWidth width, Visitor&& visitor) {
+    switch (width) {
+        case IGraphStorage::CostWidth::INT8:
+            return visitor(std::type_identity<int8_t>{});
+        case IGraphStorage::CostWidth::INT16:
+            return visitor(std::type_identity<int16_t>{});
+        case IGraphStorage::CostWidth::INT32:
+            return visitor(std::type_identity<int32_t>{});
+        default:
+            throw std::runtime_error{"Unknown graph storage cost width."};
+    }
+}
+
+/**
+ * Resolves the concrete storage behind an IGraphStorage once and hands it to the
+ * visitor, so a generic lambda gets instantiated per storage type. Loops written
+ * against `storage.neighbours(node)` inside the visitor are then fully inlined
+ * instead of paying a std::function call for every edge. Lists and matrices are
+ * resolved down to their cost width as well.
+ */
+template <typename Visitor>
+void visitGraphStorage(const IGraphStorage& storage, Visitor&& visitor) {
+    switch (storage.type()) {
+        case IGraphStorage::Type::ADJACENCY_LIST:
+            visitCostWidth(storage.costWidth(), [&]<typename StoredCost_t>(
+                                                    std::type_identity<StoredCost_t>) {
+                visitor(static_cast<const AdjacencyList<StoredCost_t>&>(storage));
+            });
+            break;
+        case IGraphStorage::Type::ADJACENCY_MATRIX:
+            visitCostWidth(storage.costWidth(), [&]<typename StoredCost_t>(
+                                                    std::type_identity<StoredCost_t>) {
+                visitor(static_cast<const AdjacencyMatrix<StoredCost_t>&>(storage));
+            });
+            break;
+        case IGraphStorage::Type::COMPRESSED_SPARSE_ROW:
+            visitor(static_cast<const CompressedSparseRow&>(storage));
+            break;
+        case IGraphStorage::Type::BIT_MATRIX:
+            visitor(static_cast<const BitMatrix&>(storage));
+            break;
+        case IGraphStorage::Type::COMPLETE_GRAPH:
+            visitor(static_cast<const ImplicitCompleteGraph&>(storage));
+            break;
+        case IGraphStorage::Type::COMPRESSED_VARINT_ROW:
+            visitor(static_cast<const CompressedVarintRow&>(storage));
+            break;
+        default:
+            throw std::runtime_error{"Unknown graph storage type."};
+    }
+}
+
+template <typename Callback>
+void forEachNeighbour(const IGraphStorage& storage, NodeIndex_t node, Callback&& callback) {
+    visitGraphStorage(storage, [&](const auto& concreteStorage) {
+        for (auto&& [neighbour, cost] : concreteStorage.neighbours(node)) {
+            callback(neighbour, cost);
+        }
+    });
+}
+
+/**
+ * Same as forEachNeighbour, but an undirected pair (both directions stored) is
+ * only reported once, from its smaller endpoint, like forEachOutgoingEdge.
+ */
+template <typename Callback>
+void forEachUniqueNeighbour(const IGraphStorage& storage, NodeIndex_t node, Callback&& callback) {
+    visitGraphStorage(storage, [&](const auto& concreteStorage) {
+        for (auto&& [neighbour, cost] : concreteStorage.uniqueNeighbours(node)) {
+            callback(neighbour, cost);
+        }
+    });
+}
+
+/**
+ * Same as forEachNeighbour, but walks the edges ending in node, reporting their
+ * start nodes.
+ */
+template <typename Callback>
+void forEachIncomingNeighbour(const IGraphStorage& storage, NodeIndex_t node,
+                              Callback&& callback) {
+    visitGraphStorage(storage, [&](const auto& concreteStorage) {
+        for (auto&& [neighbour, cost] : concreteStorage.incomingNeighbours(node)) {
+            callback(neighbour, cost);
+        }
+    });
+}
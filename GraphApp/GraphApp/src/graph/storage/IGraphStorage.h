@@ -9,26 +9,64 @@ static_assert(std::is_same_v<CostType_t, int8_t> || std::is_same_v<CostType_t, i
 
 class IGraphStorage {
    public:
-    enum class Type { ADJACENCY_LIST, ADJACENCY_MATRIX };
+    struct Edge_t {
+        NodeIndex_t m_start;
+        NodeIndex_t m_end;
+        CostType_t m_cost;
+    };
+
+    enum class Type {
+        ADJACENCY_LIST,
+        ADJACENCY_MATRIX,
+        COMPRESSED_SPARSE_ROW,
+        BIT_MATRIX,
+        COMPLETE_GRAPH,
+        COMPRESSED_VARINT_ROW
+    };
+
+    // Width of the costs a storage keeps internally; the interface always speaks CostType_t.
+    enum class CostWidth { INT8, INT16, INT32 };
 
     virtual ~IGraphStorage() = default;
 
     virtual Type type() const = 0;
+    virtual CostWidth costWidth() const { return CostWidth::INT32; }
 
     virtual void resize(size_t nodeCount) = 0;
 
     virtual void addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) = 0;
     virtual void removeEdge(NodeIndex_t start, NodeIndex_t end) = 0;
 
+    // Same result as calling addEdge for every edge in order; storages that keep
+    // sorted neighbours override it to sort everything in one pass.
+    virtual void addEdges(std::span<const Edge_t> edges) {
+        for (const auto& [start, end, cost] : edges) {
+            addEdge(start, end, cost);
+        }
+    }
+
     virtual std::optional<CostType_t> getEdge(NodeIndex_t start, NodeIndex_t end) const = 0;
 
     virtual void forEachOutgoingEdge(
         NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const = 0;
     virtual void forEachOutgoingEdgeWithOpposites(
         NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const = 0;
+    virtual void forEachIncomingEdge(
+        NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const = 0;
 
     virtual void recomputeBeforeRemovingNodes(
         size_t oldNodeCount,
         const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) = 0;
     virtual void recomputeAfterAddingNode(size_t newNodeCount) = 0;
 };
+
+template <typename StoredCost_t>
+constexpr IGraphStorage::CostWidth costWidthOf() {
+    if constexpr (std::is_same_v<StoredCost_t, int8_t>) {
+        return IGraphStorage::CostWidth::INT8;
+    } else if constexpr (std::is_same_v<StoredCost_t, int16_t>) {
+        return IGraphStorage::CostWidth::INT16;
+    } else {
+        return IGraphStorage::CostWidth::INT32;
+    }
+}
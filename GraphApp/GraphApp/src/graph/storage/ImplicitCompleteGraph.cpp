@@ -0,0 +1,264 @@
+#include <pch.h>
+
+#include "ImplicitCompleteGraph.h"
+
+ImplicitCompleteGraph::ImplicitCompleteGraph(size_t nodeCount, bool withLoops)
+    : m_nodeCount(nodeCount),
+      m_cliqueSize(nodeCount),
+      m_withLoops(withLoops),
+      m_overrides(nodeCount) {}
+
+ImplicitCompleteGraph::ImplicitCompleteGraph(const IGraphStorage& source, size_t nodeCount,
+                                             bool withLoops)
+    : ImplicitCompleteGraph(nodeCount, withLoops) {
+    const auto indices = std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(nodeCount));
+    const auto edgeCount = std::transform_reduce(
+        std::execution::par, indices.begin(), indices.end(), size_t{0}, std::plus<>{},
+        [&](NodeIndex_t i) {
+            size_t degree = 0;
+            source.forEachOutgoingEdgeWithOpposites(i, [&](NodeIndex_t, CostType_t) { ++degree; });
+            return degree;
+        });
+
+    buildFromRows(edgeCount, [&](NodeIndex_t i, std::vector<RowEdge_t>& row) {
+        source.forEachOutgoingEdgeWithOpposites(
+            i, [&](NodeIndex_t j, CostType_t cost) { row.emplace_back(j, cost); });
+    });
+}
+
+IGraphStorage::Type ImplicitCompleteGraph::type() const { return Type::COMPLETE_GRAPH; }
+
+void ImplicitCompleteGraph::resize(size_t nodeCount) {
+    if (nodeCount == m_nodeCount) {
+        return;
+    }
+
+    if (nodeCount > m_nodeCount) {
+        return recomputeAfterAddingNode(nodeCount);
+    }
+
+    std::set<NodeIndex_t, std::greater<NodeIndex_t>> removedNodes;
+    for (auto node = static_cast<NodeIndex_t>(nodeCount); node < m_nodeCount; ++node) {
+        removedNodes.insert(node);
+    }
+
+    recomputeBeforeRemovingNodes(m_nodeCount, removedNodes);
+}
+
+void ImplicitCompleteGraph::addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) {
+    auto& row = m_overrides[start];
+    const auto it = findOverride(start, end);
+    const auto found = it != row.end() && it->m_end == end;
+
+    if (isImplicitEdge(start, end) && cost == 0) {
+        if (found) {
+            row.erase(it);
+        }
+        return;
+    }
+
+    if (found) {
+        it->m_cost = cost;
+    } else {
+        row.insert(it, {end, cost});
+    }
+}
+
+void ImplicitCompleteGraph::addEdges(std::span<const Edge_t> edges) {
+    const auto isEmpty =
+        m_cliqueSize == 0 && std::ranges::all_of(m_overrides, &std::vector<Override_t>::empty);
+    if (!isEmpty || edges.empty()) {
+        return IGraphStorage::addEdges(edges);
+    }
+
+    // Stable, so the last of several edges between the same nodes still wins.
+    std::vector<Edge_t> sortedEdges(edges.begin(), edges.end());
+    std::ranges::stable_sort(sortedEdges, {}, &Edge_t::m_start);
+
+    buildFromRows(sortedEdges.size(), [&](NodeIndex_t i, std::vector<RowEdge_t>& row) {
+        for (const auto& [start, end, cost] :
+             std::ranges::equal_range(sortedEdges, i, {}, &Edge_t::m_start)) {
+            row.emplace_back(end, cost);
+        }
+    });
+}
+
+void ImplicitCompleteGraph::removeEdge(NodeIndex_t start, NodeIndex_t end) {
+    auto& row = m_overrides[start];
+    const auto it = findOverride(start, end);
+    const auto found = it != row.end() && it->m_end == end;
+
+    if (!isImplicitEdge(start, end)) {
+        if (found) {
+            row.erase(it);
+        }
+        return;
+    }
+
+    if (found) {
+        it->m_cost = std::nullopt;
+    } else {
+        row.insert(it, {end, std::nullopt});
+    }
+}
+
+std::optional<CostType_t> ImplicitCompleteGraph::getEdge(NodeIndex_t start,
+                                                         NodeIndex_t end) const {
+    if (start >= m_nodeCount || end >= m_nodeCount) {
+        return std::nullopt;
+    }
+
+    const auto it = findOverride(start, end);
+    if (it != m_overrides[start].end() && it->m_end == end) {
+        return it->m_cost;
+    }
+
+    if (isImplicitEdge(start, end)) {
+        return 0;
+    }
+
+    return std::nullopt;
+}
+
+void ImplicitCompleteGraph::forEachOutgoingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : uniqueNeighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void ImplicitCompleteGraph::forEachOutgoingEdgeWithOpposites(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : neighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void ImplicitCompleteGraph::forEachIncomingEdge(
+    NodeIndex_t node, const std::function<void(NodeIndex_t, CostType_t)>& callback) const {
+    for (const auto [neighbour, cost] : incomingNeighbours(node)) {
+        callback(neighbour, cost);
+    }
+}
+
+void ImplicitCompleteGraph::recomputeBeforeRemovingNodes(
+    size_t oldNodeCount, const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) {
+    std::vector<NodeIndex_t> indexRemap(m_nodeCount, INVALID_NODE);
+    for (NodeIndex_t oldIndex = 0, newIndex = 0; oldIndex < m_nodeCount; ++oldIndex) {
+        if (!selectedNodes.contains(oldIndex)) {
+            indexRemap[oldIndex] = newIndex++;
+        }
+    }
+
+    // The remap is monotonic, so surviving clique nodes stay in front and every
+    // override row stays sorted.
+    const auto removedFromClique = std::ranges::count_if(
+        selectedNodes, [&](NodeIndex_t node) { return node < m_cliqueSize; });
+
+    std::vector<std::vector<Override_t>> newOverrides(m_nodeCount - selectedNodes.size());
+    for (NodeIndex_t i = 0; i < m_nodeCount; ++i) {
+        const auto new_i = indexRemap[i];
+        if (new_i == INVALID_NODE) {
+            continue;
+        }
+
+        auto& newRow = newOverrides[new_i];
+        for (const auto& [end, cost] : m_overrides[i]) {
+            const auto new_j = indexRemap[end];
+            if (new_j != INVALID_NODE) {
+                newRow.push_back({new_j, cost});
+            }
+        }
+    }
+
+    m_nodeCount -= selectedNodes.size();
+    m_cliqueSize -= removedFromClique;
+    m_overrides = std::move(newOverrides);
+}
+
+void ImplicitCompleteGraph::recomputeAfterAddingNode(size_t newNodeCount) {
+    m_nodeCount = newNodeCount;
+    m_overrides.resize(newNodeCount);
+}
+
+ImplicitCompleteGraph::Row ImplicitCompleteGraph::neighbours(NodeIndex_t node) const {
+    if (node >= m_nodeCount) {
+        return Row{0, INVALID_NODE, {}};
+    }
+
+    const auto implicitEnd = node < m_cliqueSize ? static_cast<NodeIndex_t>(m_cliqueSize) : 0;
+    return Row{implicitEnd, m_withLoops ? INVALID_NODE : node, m_overrides[node]};
+}
+
+std::unique_ptr<ImplicitCompleteGraph> ImplicitCompleteGraph::transposed() const {
+    auto result = std::make_unique<ImplicitCompleteGraph>(m_nodeCount, m_withLoops);
+    result->m_cliqueSize = m_cliqueSize;
+
+    // Walking the sources in order appends to every transposed row in sorted order.
+    for (NodeIndex_t i = 0; i < m_nodeCount; ++i) {
+        for (const auto& [end, cost] : m_overrides[i]) {
+            result->m_overrides[end].push_back({i, cost});
+        }
+    }
+
+    return result;
+}
+
+void ImplicitCompleteGraph::buildFromRows(
+    size_t edgeCount, const std::function<void(NodeIndex_t, std::vector<RowEdge_t>&)>& readRow) {
+    // The clique only pays off while it holds most of the edges, otherwise the
+    // removed clique edges would outnumber the edges themselves.
+    m_cliqueSize = edgeCount * 2 >= m_nodeCount * m_nodeCount ? m_nodeCount : 0;
+
+    const auto indices = std::views::iota(NodeIndex_t{0}, static_cast<NodeIndex_t>(m_nodeCount));
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](NodeIndex_t i) {
+        thread_local std::vector<RowEdge_t> row;
+        row.clear();
+        readRow(i, row);
+        std::ranges::stable_sort(row, {}, &RowEdge_t::first);
+
+        auto& overrides = m_overrides[i];
+        overrides.clear();
+
+        const auto implicitEnd = static_cast<NodeIndex_t>(i < m_cliqueSize ? m_cliqueSize : 0);
+        const auto removeImplicitUpTo = [&](NodeIndex_t& next, NodeIndex_t end) {
+            for (; next < std::min(end, implicitEnd); ++next) {
+                if (isImplicitEdge(i, next)) {
+                    overrides.push_back({next, std::nullopt});
+                }
+            }
+        };
+
+        // Both the clique and the row are sorted, so the overrides come out sorted.
+        NodeIndex_t next = 0;
+        for (auto edge = row.begin(); edge != row.end(); ++edge) {
+            const auto [end, cost] = *edge;
+            if (end >= m_nodeCount || (edge + 1 != row.end() && (edge + 1)->first == end)) {
+                continue;
+            }
+
+            removeImplicitUpTo(next, end);
+            next = std::max(next, end + 1);
+
+            if (!isImplicitEdge(i, end) || cost != 0) {
+                overrides.push_back({end, cost});
+            }
+        }
+
+        removeImplicitUpTo(next, implicitEnd);
+    });
+}
+
+bool ImplicitCompleteGraph::isImplicitEdge(NodeIndex_t start, NodeIndex_t end) const {
+    return start < m_cliqueSize && end < m_cliqueSize && (m_withLoops || start != end);
+}
+
+std::vector<ImplicitCompleteGraph::Override_t>::iterator ImplicitCompleteGraph::findOverride(
+    NodeIndex_t start, NodeIndex_t end) {
+    return std::ranges::lower_bound(m_overrides[start], end, {}, &Override_t::m_end);
+}
+
+std::vector<ImplicitCompleteGraph::Override_t>::const_iterator ImplicitCompleteGraph::findOverride(
+    NodeIndex_t start, NodeIndex_t end) const {
+    return std::ranges::lower_bound(m_overrides[start], end, {}, &Override_t::m_end);
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "IGraphStorage.h"
+
+/**
+ * @class ImplicitCompleteGraph
+ * @brief Complete graph whose edges are computed instead of stored.
+ *
+ * Storage Format:
+ * - Nodes [0, m_cliqueSize) are implicitly connected to each other with cost 0
+ *   (loops only when m_withLoops is set)
+ * - m_overrides[i]: sorted by end node, edges out of i that differ from the
+ *   implicit clique; an empty cost marks a removed clique edge
+ *
+ * Nodes added later are not part of the clique, so they start without edges
+ * like with the other storages. Memory is O(n + edited edges).
+ *
+ * Building from another storage, or bulk adding into an empty one, makes every
+ * node part of the clique when that holds most of the edges, and only keeps the
+ * differences from it. A frozen or saved complete graph thaws back into O(n)
+ * memory instead of storing all of its edges as overrides.
+ */
+class ImplicitCompleteGraph final : public IGraphStorage {
+   public:
+    struct Override_t {
+        NodeIndex_t m_end;
+        std::optional<CostType_t> m_cost;
+    };
+
+    class Row : public std::ranges::view_interface<Row> {
+       public:
+        class Iterator {
+           public:
+            using value_type = std::pair<NodeIndex_t, CostType_t>;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            Iterator(const Row& row)
+                : m_implicitEnd(row.m_implicitEnd),
+                  m_skippedNode(row.m_skippedNode),
+                  m_overrides(row.m_overrides) {
+                advance();
+            }
+
+            value_type operator*() const { return m_current; }
+
+            Iterator& operator++() {
+                advance();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const { return m_done; }
+
+           private:
+            void advance() {
+                while (true) {
+                    if (m_implicit == m_skippedNode) {
+                        ++m_implicit;
+                    }
+
+                    const bool implicitLeft = m_implicit < m_implicitEnd;
+                    const bool overridesLeft = m_overrideIndex < m_overrides.size();
+                    if (!implicitLeft && !overridesLeft) {
+                        m_done = true;
+                        return;
+                    }
+
+                    if (overridesLeft &&
+                        (!implicitLeft || m_overrides[m_overrideIndex].m_end <= m_implicit)) {
+                        const auto& entry = m_overrides[m_overrideIndex++];
+                        if (implicitLeft && entry.m_end == m_implicit) {
+                            ++m_implicit;
+                        }
+
+                        if (!entry.m_cost) {
+                            continue;
+                        }
+
+                        m_current = {entry.m_end, entry.m_cost.value()};
+                        return;
+                    }
+
+                    m_current = {m_implicit++, CostType_t{0}};
+                    return;
+                }
+            }
+
+            NodeIndex_t m_implicit{0};
+            NodeIndex_t m_implicitEnd{0};
+            NodeIndex_t m_skippedNode{INVALID_NODE};
+
+            std::span<const Override_t> m_overrides{};
+            size_t m_overrideIndex{0};
+
+            value_type m_current{};
+            bool m_done{false};
+        };
+
+        Row(NodeIndex_t implicitEnd, NodeIndex_t skippedNode, std::span<const Override_t> overrides)
+            : m_implicitEnd(implicitEnd), m_skippedNode(skippedNode), m_overrides(overrides) {}
+
+        Iterator begin() const { return Iterator{*this}; }
+        std::default_sentinel_t end() const { return {}; }
+
+       private:
+        NodeIndex_t m_implicitEnd;
+        NodeIndex_t m_skippedNode;
+        std::span<const Override_t> m_overrides;
+    };
+
+    ImplicitCompleteGraph() = default;
+    ImplicitCompleteGraph(size_t nodeCount, bool withLoops);
+    ImplicitCompleteGraph(const IGraphStorage& source, size_t nodeCount, bool withLoops);
+
+    Type type() const override;
+
+    void resize(size_t nodeCount) override;
+
+    void addEdge(NodeIndex_t start, NodeIndex_t end, CostType_t cost) override;
+    void addEdges(std::span<const Edge_t> edges) override;
+    void removeEdge(NodeIndex_t start, NodeIndex_t end) override;
+
+    std::optional<CostType_t> getEdge(NodeIndex_t start, NodeIndex_t end) const override;
+
+    void forEachOutgoingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachOutgoingEdgeWithOpposites(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+    void forEachIncomingEdge(
+        NodeIndex_t node,
+        const std::function<void(NodeIndex_t, CostType_t)>& callback) const override;
+
+    void recomputeBeforeRemovingNodes(
+        size_t oldNodeCount,
+        const std::set<NodeIndex_t, std::greater<NodeIndex_t>>& selectedNodes) override;
+    void recomputeAfterAddingNode(size_t newNodeCount) override;
+
+    Row neighbours(NodeIndex_t node) const;
+
+    auto uniqueNeighbours(NodeIndex_t node) const {
+        return neighbours(node) | std::views::filter([this, node](const auto& neighbour) {
+                   return node < neighbour.first || !getEdge(neighbour.first, node);
+               });
+    }
+
+    auto incomingNeighbours(NodeIndex_t node) const {
+        const auto rows = static_cast<NodeIndex_t>(node < m_nodeCount ? m_nodeCount : 0);
+
+        return std::views::iota(NodeIndex_t{0}, rows) |
+               std::views::transform([this, node](NodeIndex_t i) {
+                   return std::make_pair(i, getEdge(i, node));
+               }) |
+               std::views::filter([](const auto& source) { return source.second.has_value(); }) |
+               std::views::transform([](const auto& source) {
+                   return std::make_pair(source.first, source.second.value());
+               });
+    }
+
+    std::unique_ptr<ImplicitCompleteGraph> transposed() const;
+
+   private:
+    using RowEdge_t = std::pair<NodeIndex_t, CostType_t>;
+
+    // Replaces all edges with the ones readRow appends for every node.
+    void buildFromRows(size_t edgeCount,
+                       const std::function<void(NodeIndex_t, std::vector<RowEdge_t>&)>& readRow);
+
+    bool isImplicitEdge(NodeIndex_t start, NodeIndex_t end) const;
+
+    std::vector<Override_t>::iterator findOverride(NodeIndex_t start, NodeIndex_t end);
+    std::vector<Override_t>::const_iterator findOverride(NodeIndex_t start, NodeIndex_t end) const;
+
+    size_t m_nodeCount{0};
+    size_t m_cliqueSize{0};
+    bool m_withLoops{false};
+
+    std::vector<std::vector<Override_t>> m_overrides{};
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "IGraphStorage.h"
+
+/**
+ * @class IncomingEdgeIndex
+ * @brief Transposed copy of a sparse storage's edges, built on demand.
+ *
+ * Storage Format:
+ * - m_offsets: nodeCount + 1 entries, row j spans [m_offsets[j], m_offsets[j + 1])
+ * - m_sources: every i with an edge (i, j), sorted ascending inside a row
+ * - m_costs:   edge costs, parallel to m_sources
+ *
+ * Sparse storages only know their outgoing edges, so the owning storage builds
+ * this once, on the first incoming-edge query, and clears it on every edit.
+ */
+class IncomingEdgeIndex {
+   public:
+    template <typename Storage>
+    void build(const Storage& storage, size_t nodeCount) {
+        m_offsets.assign(nodeCount + 1, 0);
+        for (NodeIndex_t i = 0; i < nodeCount; ++i) {
+            for (auto&& [j, cost] : storage.neighbours(i)) {
+                ++m_offsets[j + 1];
+            }
+        }
+        std::inclusive_scan(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+        m_sources.resize(m_offsets.back());
+        m_costs.resize(m_offsets.back());
+
+        // Sources are visited in increasing order, which keeps every row sorted.
+        auto cursors = m_offsets;
+        for (NodeIndex_t i = 0; i < nodeCount; ++i) {
+            for (auto&& [j, cost] : storage.neighbours(i)) {
+                const auto position = cursors[j]++;
+                m_sources[position] = i;
+                m_costs[position] = cost;
+            }
+        }
+
+        m_built = true;
+    }
+
+    void clear() {
+        m_offsets.clear();
+        m_sources.clear();
+        m_costs.clear();
+        m_built = false;
+    }
+
+    bool isBuilt() const { return m_built; }
+
+    auto neighbours(NodeIndex_t node) const {
+        const auto first = node + 1 < m_offsets.size() ? m_offsets[node] : 0;
+        const auto last = node + 1 < m_offsets.size() ? m_offsets[node + 1] : 0;
+
+        return std::views::iota(first, last) | std::views::transform([this](size_t position) {
+                   return std::make_pair(m_sources[position], m_costs[position]);
+               });
+    }
+
+   private:
+    std::vector<size_t> m_offsets{};
+    std::vector<NodeIndex_t> m_sources{};
+    std::vector<CostType_t> m_costs{};
+    bool m_built{false};
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+/**
+ * @class NeighbourArena
+ * @brief Per-row entry lists carved out of one shared buffer.
+ *
+ * Storage Format:
+ * - m_entries: every row's entries, each row in one contiguous block
+ * - m_blocks:  per row, the block offset, the used size and the capacity
+ * - m_freeBlocks[k]: offsets of released blocks holding at least 2^k entries
+ *
+ * A row that runs out of room moves to a block twice as large, taken from the
+ * matching size class or from the end of the buffer; its old block is kept for
+ * reuse by another row. Rows cost 16 bytes of bookkeeping instead of a vector
+ * and a heap allocation each, and dropping the arena frees a single buffer.
+ *
+ * repack() lays all rows out back to back again and drops the free blocks; it
+ * also runs by itself once more than half of the buffer sits in free blocks.
+ */
+template <typename Entry>
+class NeighbourArena {
+   public:
+    struct Block_t {
+        size_t m_offset{0};
+        uint32_t m_size{0};
+        uint32_t m_capacity{0};
+    };
+
+    size_t size() const { return m_blocks.size(); }
+
+    void resize(size_t rowCount) {
+        for (size_t row = rowCount; row < m_blocks.size(); ++row) {
+            release(m_blocks[row]);
+        }
+
+        m_blocks.resize(rowCount);
+    }
+
+    std::span<Entry> operator[](size_t row) {
+        const auto& block = m_blocks[row];
+        return {m_entries.data() + block.m_offset, block.m_size};
+    }
+
+    std::span<const Entry> operator[](size_t row) const {
+        const auto& block = m_blocks[row];
+        return {m_entries.data() + block.m_offset, block.m_size};
+    }
+
+    void insert(size_t row, size_t position, const Entry& entry) {
+        if (m_blocks[row].m_size == m_blocks[row].m_capacity) {
+            grow(row);
+        }
+
+        auto& block = m_blocks[row];
+        const auto first = m_entries.begin() + block.m_offset;
+        std::move_backward(first + position, first + block.m_size, first + block.m_size + 1);
+        first[position] = entry;
+        ++block.m_size;
+    }
+
+    void erase(size_t row, size_t position) {
+        auto& block = m_blocks[row];
+        const auto first = m_entries.begin() + block.m_offset;
+        std::move(first + position + 1, first + block.m_size, first + position);
+        --block.m_size;
+    }
+
+    uint32_t capacity(size_t row) const { return m_blocks[row].m_capacity; }
+
+    // Only touches the row's own bookkeeping, so distinct rows can be resized in parallel.
+    void resizeRow(size_t row, uint32_t size) { m_blocks[row].m_size = size; }
+
+    void repack(std::span<const uint32_t> capacities) {
+        std::vector<Block_t> blocks(m_blocks.size());
+        size_t offset = 0;
+        for (size_t row = 0; row < m_blocks.size(); ++row) {
+            blocks[row] = {offset, m_blocks[row].m_size, capacities[row]};
+            offset += capacities[row];
+        }
+
+        std::vector<Entry> entries(offset);
+        const auto rows = std::views::iota(size_t{0}, m_blocks.size());
+        std::for_each(std::execution::par, rows.begin(), rows.end(), [&](size_t row) {
+            std::copy_n(m_entries.begin() + m_blocks[row].m_offset, m_blocks[row].m_size,
+                        entries.begin() + blocks[row].m_offset);
+        });
+
+        m_entries = std::move(entries);
+        m_blocks = std::move(blocks);
+        for (auto& freeBlocks : m_freeBlocks) {
+            freeBlocks.clear();
+        }
+        m_freeEntries = 0;
+    }
+
+   private:
+    static constexpr uint32_t k_minCapacity = 2;
+
+    static size_t sizeClass(uint32_t capacity) { return std::bit_width(capacity) - 1; }
+
+    void grow(size_t row) {
+        if (m_freeEntries > m_entries.size() / 2) {
+            std::vector<uint32_t> capacities(m_blocks.size());
+            std::ranges::transform(m_blocks, capacities.begin(), &Block_t::m_capacity);
+            repack(capacities);
+        }
+
+        auto& block = m_blocks[row];
+        const auto capacity = std::max(k_minCapacity, std::bit_ceil(block.m_capacity + 1));
+        const auto offset = allocate(capacity);
+        std::copy_n(m_entries.begin() + block.m_offset, block.m_size, m_entries.begin() + offset);
+
+        release(block);
+        block.m_offset = offset;
+        block.m_capacity = capacity;
+    }
+
+    size_t allocate(uint32_t capacity) {
+        auto& freeBlocks = m_freeBlocks[sizeClass(capacity)];
+        if (!freeBlocks.empty()) {
+            const auto offset = freeBlocks.back();
+            freeBlocks.pop_back();
+            m_freeEntries -= capacity;
+            return offset;
+        }
+
+        const auto offset = m_entries.size();
+        m_entries.resize(offset + capacity);
+        return offset;
+    }
+
+    // A block that is not a power of two only gets handed out again at the size
+    // class below it.
+    void release(const Block_t& block) {
+        if (block.m_capacity == 0) {
+            return;
+        }
+
+        const auto sizeClassIndex = sizeClass(block.m_capacity);
+        m_freeBlocks[sizeClassIndex].push_back(block.m_offset);
+        m_freeEntries += size_t{1} << sizeClassIndex;
+    }
+
+    std::vector<Entry> m_entries{};
+    std::vector<Block_t> m_blocks{};
+    std::array<std::vector<size_t>, 32> m_freeBlocks{};
+    size_t m_freeEntries{0};
+};